@@ -0,0 +1,224 @@
+#pragma once
+
+#include <optional>
+
+#include "pipeable.hpp"
+
+namespace millrind
+{
+namespace agg
+{
+namespace detail
+{
+struct count_aggregator
+{
+    template <class T>
+    std::size_t init() const
+    {
+        return 0;
+    }
+
+    template <class T>
+    void add(std::size_t& state, T&&) const
+    {
+        ++state;
+    }
+
+    void merge(std::size_t& state, std::size_t other) const
+    {
+        state += other;
+    }
+
+    std::size_t result(std::size_t state) const
+    {
+        return state;
+    }
+};
+
+template <class Proj>
+struct sum_aggregator
+{
+    Proj proj;
+
+    template <class T>
+    auto init() const
+    {
+        return std::decay_t<decltype(call(proj, std::declval<T>()))>{};
+    }
+
+    template <class S, class T>
+    void add(S& state, T&& item) const
+    {
+        state += call(proj, std::forward<T>(item));
+    }
+
+    template <class S>
+    void merge(S& state, S other) const
+    {
+        state += std::move(other);
+    }
+
+    template <class S>
+    S result(S state) const
+    {
+        return state;
+    }
+};
+
+template <class Compare, class Proj>
+struct extremum_aggregator
+{
+    Compare compare;
+    Proj proj;
+
+    template <class T>
+    auto init() const
+    {
+        return std::optional<std::decay_t<decltype(call(proj, std::declval<T>()))>>{};
+    }
+
+    template <class S, class T>
+    void add(S& state, T&& item) const
+    {
+        update(state, call(proj, std::forward<T>(item)));
+    }
+
+    template <class S>
+    void merge(S& state, S other) const
+    {
+        if (other)
+            update(state, *std::move(other));
+    }
+
+    template <class S>
+    auto result(S state) const
+    {
+        return *std::move(state);
+    }
+
+private:
+    template <class S, class V>
+    void update(S& state, V&& value) const
+    {
+        if (!state || call(compare, value, *state))
+            state = std::forward<V>(value);
+    }
+};
+
+template <class Proj>
+struct avg_aggregator
+{
+    Proj proj;
+
+    template <class T>
+    std::pair<double, std::size_t> init() const
+    {
+        return { 0.0, 0 };
+    }
+
+    template <class T>
+    void add(std::pair<double, std::size_t>& state, T&& item) const
+    {
+        state.first += call(proj, std::forward<T>(item));
+        ++state.second;
+    }
+
+    void merge(std::pair<double, std::size_t>& state, std::pair<double, std::size_t> other) const
+    {
+        state.first += other.first;
+        state.second += other.second;
+    }
+
+    double result(std::pair<double, std::size_t> state) const
+    {
+        return state.second != 0 ? state.first / state.second : 0.0;
+    }
+};
+
+template <class T, class Add, class Merge, class Result>
+struct custom_aggregator
+{
+    T init_value;
+    Add add_func;
+    Merge merge_func;
+    Result result_func;
+
+    template <class>
+    T init() const
+    {
+        return init_value;
+    }
+
+    template <class U>
+    void add(T& state, U&& item) const
+    {
+        state = call(add_func, std::move(state), std::forward<U>(item));
+    }
+
+    void merge(T& state, T other) const
+    {
+        state = call(merge_func, std::move(state), std::move(other));
+    }
+
+    auto result(T state) const
+    {
+        return call(result_func, std::move(state));
+    }
+};
+
+struct count_fn
+{
+    auto operator()() const
+    {
+        return count_aggregator{};
+    }
+};
+
+struct sum_fn
+{
+    template <class Proj = identity>
+    auto operator()(Proj proj = {}) const
+    {
+        return sum_aggregator<Proj>{ std::move(proj) };
+    }
+};
+
+template <class Compare>
+struct extremum_fn
+{
+    template <class Proj = identity>
+    auto operator()(Proj proj = {}) const
+    {
+        return extremum_aggregator<Compare, Proj>{ Compare{}, std::move(proj) };
+    }
+};
+
+struct avg_fn
+{
+    template <class Proj = identity>
+    auto operator()(Proj proj = {}) const
+    {
+        return avg_aggregator<Proj>{ std::move(proj) };
+    }
+};
+
+struct make_fn
+{
+    template <class T, class Add, class Merge, class Result = identity>
+    auto operator()(T init, Add add, Merge merge, Result result = {}) const
+    {
+        return custom_aggregator<T, Add, Merge, Result>{ std::move(init), std::move(add), std::move(merge), std::move(result) };
+    }
+};
+
+}  // namespace detail
+
+static constexpr inline auto count = detail::count_fn{};
+static constexpr inline auto sum = detail::sum_fn{};
+static constexpr inline auto min = detail::extremum_fn<std::less<>>{};
+static constexpr inline auto max = detail::extremum_fn<std::greater<>>{};
+static constexpr inline auto avg = detail::avg_fn{};
+static constexpr inline auto make = detail::make_fn{};
+
+}  // namespace agg
+}  // namespace millrind
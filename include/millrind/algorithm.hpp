@@ -4,11 +4,23 @@
 #include <functional>
 #include <numeric>
 
+#include "operation_count.hpp"
 #include "pipeable.hpp"
 #include "return_policy.hpp"
 
+#ifdef MILLRIND_COUNT_OPERATIONS
+#define MILLRIND_OPERATION_SITE_NAME(line) MILLRIND_OPERATION_SITE_NAME_IMPL(line)
+#define MILLRIND_OPERATION_SITE_NAME_IMPL(line) _millrind_operation_site_##line
+#define MILLRIND_CHECK_CONSTRAINT(func, var, constraint)                                                       \
+    static_assert(is_detected_v<constraint, decltype(var)>, func ": '" #var "' - " #constraint " required"); \
+    const ::millrind::detail::operation_site_guard MILLRIND_OPERATION_SITE_NAME(__LINE__)                     \
+    {                                                                                                         \
+        func                                                                                                  \
+    }
+#else
 #define MILLRIND_CHECK_CONSTRAINT(func, var, constraint) \
     static_assert(is_detected_v<constraint, decltype(var)>, func ": '" #var "' - " #constraint " required")
+#endif
 
 namespace millrind
 {
@@ -29,6 +41,11 @@ struct invoke_binary
     template <class T, class U>
     constexpr decltype(auto) operator()(T&& lhs, U&& rhs) const
     {
+#ifdef MILLRIND_COUNT_OPERATIONS
+        count_comparison();
+        count_projection<Proj1>();
+        count_projection<Proj2>();
+#endif
         return call(func, call(proj1, std::forward<T>(lhs)), call(proj2, std::forward<U>(rhs)));
     }
 };
@@ -42,6 +59,11 @@ struct invoke_binary<Func, Proj, void>
     template <class T, class U>
     constexpr decltype(auto) operator()(T&& lhs, U&& rhs) const
     {
+#ifdef MILLRIND_COUNT_OPERATIONS
+        count_comparison();
+        count_projection<Proj>();
+        count_projection<Proj>();
+#endif
         return call(func, call(proj, std::forward<T>(lhs)), call(proj, std::forward<U>(rhs)));
     }
 };
@@ -110,13 +132,13 @@ Iter get_bound(Iter b, Iter e, Op op)
 template <class Iter, class T, class Compare, class Proj>
 Iter lower_bound(Iter b, Iter e, const T& value, Compare compare, Proj proj)
 {
-    return get_bound(b, e, [&](auto it) { return call(compare, call(proj, *it), value); });
+    return get_bound(b, e, [&](auto it) { return invoke_binary{ ref(compare), ref(proj), identity{} }(*it, value); });
 }
 
 template <class Iter, class T, class Compare, class Proj>
 Iter upper_bound(Iter b, Iter e, const T& value, Compare compare, Proj proj)
 {
-    return get_bound(b, e, [&](auto it) { return !call(compare, value, call(proj, *it)); });
+    return get_bound(b, e, [&](auto it) { return !invoke_binary{ ref(compare), identity{}, ref(proj) }(value, *it); });
 }
 
 template <class Iter, class T, class Compare, class Proj>
@@ -167,7 +189,7 @@ auto all_of(Range&& range, UnaryPred pred, Proj proj = {})
 {
     MILLRIND_CHECK_CONSTRAINT("all_of", range, input_range);
 
-    return std::all_of(std::begin(range), std::end(range), fn(ref(proj), ref(pred)));
+    return std::all_of(std::begin(range), std::end(range), fn(detail::count_projections(ref(proj)), ref(pred)));
 }
 
 template <class Range, class UnaryPred, class Proj = identity>
@@ -175,7 +197,7 @@ auto any_of(Range&& range, UnaryPred pred, Proj proj = {})
 {
     MILLRIND_CHECK_CONSTRAINT("any_of", range, input_range);
 
-    return std::any_of(std::begin(range), std::end(range), fn(ref(proj), ref(pred)));
+    return std::any_of(std::begin(range), std::end(range), fn(detail::count_projections(ref(proj)), ref(pred)));
 }
 
 template <class Range, class OutputIter>
@@ -191,7 +213,7 @@ auto copy_if(Range&& range, OutputIter output, UnaryPred pred, Proj proj = {})
 {
     MILLRIND_CHECK_CONSTRAINT("copy_if", range, input_range);
 
-    return std::copy_if(std::begin(range), std::end(range), output, fn(ref(proj), ref(pred)));
+    return std::copy_if(std::begin(range), std::end(range), output, fn(detail::count_projections(ref(proj)), ref(pred)));
 }
 
 template <class Range, class Size, class OutputIter>
@@ -207,7 +229,7 @@ auto count(Range&& range, const T& value, Proj proj = {})
 {
     MILLRIND_CHECK_CONSTRAINT("count", range, input_range);
 
-    return std::count_if(std::begin(range), std::end(range), fn(ref(proj), detail::equal_to(ref(value))));
+    return std::count_if(std::begin(range), std::end(range), fn(detail::count_projections(ref(proj)), detail::equal_to(ref(value))));
 }
 
 template <class Range, class UnaryPred, class Proj = identity>
@@ -215,7 +237,7 @@ auto count_if(Range&& range, UnaryPred pred, Proj proj = {})
 {
     MILLRIND_CHECK_CONSTRAINT("count_if", range, input_range);
 
-    return std::count_if(std::begin(range), std::end(range), fn(ref(proj), ref(pred)));
+    return std::count_if(std::begin(range), std::end(range), fn(detail::count_projections(ref(proj)), ref(pred)));
 }
 
 template <class Range1, class Range2, class BinaryPred = std::equal_to<>, class Proj1 = identity, class Proj2 = identity>
@@ -260,7 +282,7 @@ decltype(auto) find(Range&& range, const T& value, Proj proj = {})
     MILLRIND_CHECK_CONSTRAINT("find", range, input_range);
 
     return detail::invoke_algorithm<Policy>(std::begin(range), std::end(range), [&](auto b, auto e) {
-        return std::find_if(b, e, fn(ref(proj), detail::equal_to(ref(value))));
+        return std::find_if(b, e, fn(detail::count_projections(ref(proj)), detail::equal_to(ref(value))));
     });
 }
 
@@ -270,7 +292,7 @@ decltype(auto) find_if(Range&& range, UnaryPred pred, Proj proj = {})
     MILLRIND_CHECK_CONSTRAINT("find_if", range, input_range);
 
     return detail::invoke_algorithm<Policy>(std::begin(range), std::end(range), [&](auto b, auto e) {
-        return std::find_if(b, e, fn(ref(proj), ref(pred)));
+        return std::find_if(b, e, fn(detail::count_projections(ref(proj)), ref(pred)));
     });
 }
 
@@ -280,7 +302,7 @@ decltype(auto) find_if_not(Range&& range, UnaryPred pred, Proj proj = {})
     MILLRIND_CHECK_CONSTRAINT("find_if_not", range, input_range);
 
     return detail::invoke_algorithm<Policy>(std::begin(range), std::end(range), [&](auto b, auto e) {
-        return std::find_if_not(b, e, fn(ref(proj), ref(pred)));
+        return std::find_if_not(b, e, fn(detail::count_projections(ref(proj)), ref(pred)));
     });
 }
 
@@ -333,7 +355,7 @@ auto for_each(Range&& range, UnaryFunc func, Proj proj = {})
 {
     MILLRIND_CHECK_CONSTRAINT("for_each", range, input_range);
 
-    return std::for_each(std::begin(range), std::end(range), fn(ref(proj), ref(func)));
+    return std::for_each(std::begin(range), std::end(range), fn(detail::count_projections(ref(proj)), ref(func)));
 }
 
 template <class Range, class Generator>
@@ -430,7 +452,7 @@ auto is_partitioned(Range&& range, UnaryPred pred, Proj proj = {})
 {
     MILLRIND_CHECK_CONSTRAINT("is_partitioned", range, input_range);
 
-    return std::is_partitioned(std::begin(range), std::end(range), fn(ref(proj), ref(pred)));
+    return std::is_partitioned(std::begin(range), std::end(range), fn(detail::count_projections(ref(proj)), ref(pred)));
 }
 
 template <class Range1, class Range2, class BinaryPred = std::equal_to<>, class Proj1 = identity, class Proj2 = identity>
@@ -598,7 +620,7 @@ auto none_of(Range&& range, UnaryPred pred, Proj proj = {})
 {
     MILLRIND_CHECK_CONSTRAINT("none_of", range, input_range);
 
-    return std::none_of(std::begin(range), std::end(range), fn(ref(proj), ref(pred)));
+    return std::none_of(std::begin(range), std::end(range), fn(detail::count_projections(ref(proj)), ref(pred)));
 }
 
 template <class Range, class Compare = std::less<>, class Proj = identity>
@@ -653,7 +675,7 @@ decltype(auto) partition(Range&& range, UnaryPred pred, Proj proj = {})
     MILLRIND_CHECK_CONSTRAINT("partition", range, forward_range);
 
     return detail::invoke_algorithm<Policy>(std::begin(range), std::end(range), [&](auto b, auto e) {
-        return std::partition(b, e, fn(ref(proj), ref(pred)));
+        return std::partition(b, e, fn(detail::count_projections(ref(proj)), ref(pred)));
     });
 }
 
@@ -663,7 +685,7 @@ auto partition_copy(Range&& range, OutputIter1 result_true, OutputIter2 result_f
     MILLRIND_CHECK_CONSTRAINT("partition_copy", range, input_range);
 
     return std::partition_copy(
-        std::begin(range), std::end(range), result_true, result_false, fn(ref(proj), ref(pred)));
+        std::begin(range), std::end(range), result_true, result_false, fn(detail::count_projections(ref(proj)), ref(pred)));
 }
 
 template <class Policy = default_return_policy, class Range, class UnaryPred, class Proj = identity>
@@ -672,7 +694,7 @@ decltype(auto) stable_partition(Range&& range, UnaryPred pred, Proj proj = {})
     MILLRIND_CHECK_CONSTRAINT("stable_partition", range, bidirectional_range);
 
     return detail::invoke_algorithm<Policy>(std::begin(range), std::end(range), [&](auto b, auto e) {
-        return std::stable_partition(b, e, fn(ref(proj), ref(pred)));
+        return std::stable_partition(b, e, fn(detail::count_projections(ref(proj)), ref(pred)));
     });
 }
 
@@ -705,7 +727,7 @@ decltype(auto) remove(Range&& range, const T& value, Proj proj = {})
     MILLRIND_CHECK_CONSTRAINT("remove", range, forward_range);
 
     return detail::invoke_algorithm<Policy>(std::begin(range), std::end(range), [&](auto b, auto e) {
-        return std::remove_if(b, e, fn(ref(proj), detail::equal_to(ref(value))));
+        return std::remove_if(b, e, fn(detail::count_projections(ref(proj)), detail::equal_to(ref(value))));
     });
 }
 
@@ -715,7 +737,7 @@ decltype(auto) remove_if(Range&& range, UnaryPred pred, Proj proj = {})
     MILLRIND_CHECK_CONSTRAINT("remove_if", range, forward_range);
 
     return detail::invoke_algorithm<Policy>(std::begin(range), std::end(range), [&](auto b, auto e) {
-        return std::remove_if(b, e, fn(ref(proj), ref(pred)));
+        return std::remove_if(b, e, fn(detail::count_projections(ref(proj)), ref(pred)));
     });
 }
 
@@ -724,7 +746,7 @@ auto remove_copy(Range&& range, OutputIter output, const T& value, Proj proj = {
 {
     MILLRIND_CHECK_CONSTRAINT("remove_copy", range, input_range);
 
-    return std::remove_copy_if(std::begin(range), std::end(range), output, fn(ref(proj), detail::equal_to(ref(value))));
+    return std::remove_copy_if(std::begin(range), std::end(range), output, fn(detail::count_projections(ref(proj)), detail::equal_to(ref(value))));
 }
 
 template <class Range, class OutputIter, class UnaryPred, class Proj = identity>
@@ -732,7 +754,7 @@ auto remove_copy_if(Range&& range, OutputIter output, UnaryPred pred, Proj proj
 {
     MILLRIND_CHECK_CONSTRAINT("remove_copy_if", range, input_range);
 
-    return std::remove_copy_if(std::begin(range), std::end(range), output, fn(ref(proj), ref(pred)));
+    return std::remove_copy_if(std::begin(range), std::end(range), output, fn(detail::count_projections(ref(proj)), ref(pred)));
 }
 
 template <class Range, class T1, class T2, class Proj = identity>
@@ -740,7 +762,7 @@ void raplace(Range&& range, const T1& old_value, const T2& new_value, Proj proj
 {
     MILLRIND_CHECK_CONSTRAINT("replace", range, forward_range);
 
-    std::replace_if(std::begin(range), std::end(range), fn(ref(proj), detail::equal_to(ref(old_value))), new_value);
+    std::replace_if(std::begin(range), std::end(range), fn(detail::count_projections(ref(proj)), detail::equal_to(ref(old_value))), new_value);
 }
 
 template <class Range, class UnaryPred, class T, class Proj = identity>
@@ -748,7 +770,7 @@ void raplace_if(Range&& range, UnaryPred pred, const T& new_value, Proj proj = {
 {
     MILLRIND_CHECK_CONSTRAINT("replace_if", range, forward_range);
 
-    std::replace_if(std::begin(range), std::end(range), fn(ref(proj), ref(pred)), new_value);
+    std::replace_if(std::begin(range), std::end(range), fn(detail::count_projections(ref(proj)), ref(pred)), new_value);
 }
 
 template <class Range, class OutputIter, class T1, class T2, class Proj = identity>
@@ -757,7 +779,7 @@ auto replace_copy(Range&& range, OutputIter output, const T1& old_value, const T
     MILLRIND_CHECK_CONSTRAINT("replace_copy", range, input_range);
 
     return std::replace_copy_if(
-        std::begin(range), std::end(range), output, fn(ref(proj), detail::equal_to(ref(old_value))), new_value);
+        std::begin(range), std::end(range), output, fn(detail::count_projections(ref(proj)), detail::equal_to(ref(old_value))), new_value);
 }
 
 template <class Range, class OutputIter, class UnaryPred, class T, class Proj = identity>
@@ -765,7 +787,7 @@ auto replace_copy_if(Range&& range, OutputIter output, UnaryPred pred, const T&
 {
     MILLRIND_CHECK_CONSTRAINT("replace_copy_if", range, input_range);
 
-    return std::replace_copy_if(std::begin(range), std::end(range), output, fn(ref(proj), ref(pred)), new_value);
+    return std::replace_copy_if(std::begin(range), std::end(range), output, fn(detail::count_projections(ref(proj)), ref(pred)), new_value);
 }
 
 template <class Range>
@@ -993,7 +1015,7 @@ auto transform(Range&& range, OutputIter output, UnaryFunc func, Proj proj = {})
 {
     MILLRIND_CHECK_CONSTRAINT("transform", range, input_range);
 
-    return std::transform(std::begin(range), std::end(range), output, fn(ref(proj), ref(func)));
+    return std::transform(std::begin(range), std::end(range), output, fn(detail::count_projections(ref(proj)), ref(func)));
 }
 
 template <
@@ -1020,19 +1042,19 @@ auto transform(Range1&& range1, Range2&& range2, OutputIter output, BinaryFunc f
 template <class Range, class Output, class T, class BinaryFunc, class UnaryFunc, class Proj = identity>
 auto transform_exclusive_scan(Range&& range, Output output, T init, BinaryFunc func, UnaryFunc op, Proj proj = {})
 {
-    return std::transform_exclusive_scan(std::begin(range), std::end(range), output, init, func, fn(ref(proj), ref(op)));
+    return std::transform_exclusive_scan(std::begin(range), std::end(range), output, init, func, fn(detail::count_projections(ref(proj)), ref(op)));
 }
 
 template <class Range, class Output, class BinaryFunc, class UnaryFunc, class Proj = identity>
 auto transform_inclusive_scan(Range&& range, Output output, BinaryFunc func, UnaryFunc op, Proj proj = {})
 {
-    return std::transform_inclusive_scan(std::begin(range), std::end(range), output, ref(func), fn(ref(proj), ref(op)));
+    return std::transform_inclusive_scan(std::begin(range), std::end(range), output, ref(func), fn(detail::count_projections(ref(proj)), ref(op)));
 }
 
 template <class Range, class T, class BinaryFunc, class UnaryFunc, class Proj = identity>
 auto transform_reduce(Range&& range, T init, BinaryFunc func, UnaryFunc op, Proj proj = {})
 {
-    return std::transform_reduce(std::begin(range), std::end(range), std::move(init), ref(func), fn(ref(proj), ref(op)));
+    return std::transform_reduce(std::begin(range), std::end(range), std::move(init), ref(func), fn(detail::count_projections(ref(proj)), ref(op)));
 }
 
 template <class Policy = default_return_policy, class Range, class BinaryPred = std::equal_to<>, class Proj = identity>
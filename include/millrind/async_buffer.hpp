@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+
+#include "iterator_range.hpp"
+#include "iterators/async_buffer_iterator.hpp"
+#include "pipeable.hpp"
+
+namespace millrind
+{
+namespace seq
+{
+namespace detail
+{
+struct async_buffer_fn
+{
+    static constexpr std::size_t default_capacity = 1024;
+
+    template <class Range>
+    auto operator()(Range&& range, std::size_t capacity = default_capacity) const
+    {
+        using state_type = ::millrind::detail::async_buffer_state<iterator_t<Range>>;
+        using result_type = async_buffer_iterator<iterator_t<Range>>;
+
+        auto state = std::make_shared<state_type>(std::begin(range), std::end(range), capacity);
+        return make_range(result_type{ std::move(state) }, result_type{});
+    }
+};
+
+}  // namespace detail
+
+static constexpr inline auto async_buffer = pipeable{ detail::async_buffer_fn{} };
+
+}  // namespace seq
+
+}  // namespace millrind
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include "concurrent_queue.hpp"
+#include "format.hpp"
+#include "writer.hpp"
+
+namespace millrind
+{
+class async_printer
+{
+public:
+    static constexpr std::size_t default_capacity = 4096;
+
+    explicit async_printer(int fd = STDOUT_FILENO, std::size_t capacity = default_capacity)
+        : _lines{ capacity }
+        , _free{ capacity }
+        , _writer{ fd }
+        , _submitted{ 0 }
+        , _written{ 0 }
+        , _stop{ false }
+        , _sleeping{ false }
+        , _thread{ [this] { run(); } }
+    {
+    }
+
+    async_printer(const async_printer&) = delete;
+    async_printer& operator=(const async_printer&) = delete;
+
+    ~async_printer()
+    {
+        _stop.store(true, std::memory_order_release);
+        wake();
+        _thread.join();
+    }
+
+    template <class... Args>
+    void print(const Args&... args)
+    {
+        auto& buffer = local_buffer();
+        str_append(buffer, args...);
+        submit(buffer);
+    }
+
+    template <class... Args>
+    void println(const Args&... args)
+    {
+        auto& buffer = local_buffer();
+        str_append(buffer, args..., '\n');
+        submit(buffer);
+    }
+
+    void flush()
+    {
+        const auto target = _submitted.load(std::memory_order_acquire);
+        while (_written.load(std::memory_order_acquire) < target)
+        {
+            wake();
+            std::this_thread::yield();
+        }
+    }
+
+    std::error_code error() const
+    {
+        std::lock_guard lock{ _mutex };
+        return _error;
+    }
+
+private:
+    static std::string& local_buffer()
+    {
+        thread_local std::string buffer;
+        buffer.clear();
+        return buffer;
+    }
+
+    void submit(std::string& buffer)
+    {
+        _submitted.fetch_add(1, std::memory_order_acq_rel);
+        while (!_lines.try_push(std::move(buffer)))
+        {
+            wake();
+            std::this_thread::yield();
+        }
+        if (!_free.try_pop(buffer))
+            buffer = std::string{};
+        if (_sleeping.load(std::memory_order_acquire))
+            wake();
+    }
+
+    void wake()
+    {
+        std::lock_guard lock{ _mutex };
+        _wakeup.notify_one();
+    }
+
+    bool drain()
+    {
+        std::size_t count = 0;
+        while (auto line = _lines.try_pop())
+        {
+            guarded([&] { _writer.write(*line); });
+            line->clear();
+            _free.try_push(std::move(*line));
+            ++count;
+        }
+        if (count > 0)
+        {
+            guarded([&] { _writer.flush(); });
+            _written.fetch_add(count, std::memory_order_acq_rel);
+        }
+        return count > 0;
+    }
+
+    template <class Action>
+    void guarded(Action action)
+    {
+        try
+        {
+            action();
+        }
+        catch (const std::system_error& e)
+        {
+            std::lock_guard lock{ _mutex };
+            if (!_error)
+                _error = e.code();
+        }
+    }
+
+    void run()
+    {
+        while (true)
+        {
+            if (drain())
+                continue;
+            if (_stop.load(std::memory_order_acquire))
+                break;
+
+            std::unique_lock lock{ _mutex };
+            _sleeping.store(true, std::memory_order_release);
+            _wakeup.wait_for(lock, std::chrono::milliseconds{ 1 });
+            _sleeping.store(false, std::memory_order_release);
+        }
+        drain();
+    }
+
+    mpmc_queue<std::string> _lines;
+    mpmc_queue<std::string> _free;
+    buffered_writer _writer;
+    std::atomic<std::size_t> _submitted;
+    std::atomic<std::size_t> _written;
+    std::atomic<bool> _stop;
+    std::atomic<bool> _sleeping;
+    mutable std::mutex _mutex;
+    std::condition_variable _wakeup;
+    std::error_code _error;
+    std::thread _thread;
+};
+
+namespace detail
+{
+inline async_printer& default_async_printer()
+{
+    static async_printer instance;
+    return instance;
+}
+
+struct async_print_fn
+{
+    bool newline = false;
+
+    template <class... Args>
+    void operator()(const Args&... args) const
+    {
+        if (newline)
+            default_async_printer().println(args...);
+        else
+            default_async_printer().print(args...);
+    }
+};
+
+struct async_flush_fn
+{
+    void operator()() const
+    {
+        default_async_printer().flush();
+    }
+};
+
+}  // namespace detail
+
+static constexpr inline auto async_print = detail::async_print_fn{};
+static constexpr inline auto async_println = detail::async_print_fn{ true };
+static constexpr inline auto async_flush = detail::async_flush_fn{};
+
+}  // namespace millrind
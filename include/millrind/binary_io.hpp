@@ -0,0 +1,167 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "mmap.hpp"
+#include "seq.hpp"
+#include "writer.hpp"
+
+namespace millrind
+{
+namespace detail
+{
+class file_descriptor
+{
+public:
+    file_descriptor(const std::string& path, int flags)
+        : _fd{ ::open(path.c_str(), flags | O_CLOEXEC, 0644) }
+    {
+        if (_fd < 0)
+            throw std::system_error{ errno, std::generic_category(), "cannot open '" + path + "'" };
+    }
+
+    file_descriptor(const file_descriptor&) = delete;
+    file_descriptor& operator=(const file_descriptor&) = delete;
+
+    ~file_descriptor()
+    {
+        ::close(_fd);
+    }
+
+    int get() const
+    {
+        return _fd;
+    }
+
+private:
+    int _fd;
+};
+
+template <class Range>
+using contiguous_data_t = decltype(std::data(std::declval<Range>()), std::size(std::declval<Range>()));
+
+template <class T>
+void check_binary_size(std::size_t size)
+{
+    if (size % sizeof(T) != 0)
+        throw std::runtime_error{ "binary file size is not a multiple of the element size" };
+}
+
+}  // namespace detail
+
+namespace seq
+{
+namespace detail
+{
+struct write_binary_fn
+{
+    static constexpr std::size_t buffer_size = 1 << 20;
+
+    template <class Range>
+    std::size_t operator()(Range&& range, int fd) const
+    {
+        using value_type = range_value_t<Range>;
+        static_assert(std::is_trivially_copyable_v<value_type>, "write_binary requires trivially copyable elements");
+
+        buffered_writer writer{ fd, buffer_size };
+        std::size_t count = 0;
+        if constexpr (is_detected_v<::millrind::detail::contiguous_data_t, Range&>)
+        {
+            count = std::size(range);
+            writer.write({ reinterpret_cast<const char*>(std::data(range)), count * sizeof(value_type) });
+        }
+        else
+        {
+            for (auto&& item : range)
+            {
+                const value_type value = item;
+                writer.write({ reinterpret_cast<const char*>(&value), sizeof(value_type) });
+                ++count;
+            }
+        }
+        writer.flush();
+        return count;
+    }
+
+    template <class Range>
+    std::size_t operator()(Range&& range, const std::string& path) const
+    {
+        const ::millrind::detail::file_descriptor file{ path, O_WRONLY | O_CREAT | O_TRUNC };
+        return (*this)(range, file.get());
+    }
+};
+
+template <class T>
+struct read_binary_fn
+{
+    static_assert(std::is_trivially_copyable_v<T>, "read_binary requires a trivially copyable type");
+
+    auto operator()(const std::string& path) const
+    {
+        const ::millrind::detail::file_descriptor file{ path, O_RDONLY };
+
+        struct stat info;
+        if (::fstat(file.get(), &info) != 0)
+            throw std::system_error{ errno, std::generic_category(), "cannot stat '" + path + "'" };
+
+        const auto size = static_cast<std::size_t>(info.st_size);
+        ::millrind::detail::check_binary_size<T>(size);
+
+        std::vector<T> result(size / sizeof(T));
+        auto data = reinterpret_cast<char*>(result.data());
+        for (std::size_t offset = 0; offset < size;)
+        {
+            const auto n = ::read(file.get(), data + offset, size - offset);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+                throw std::system_error{ errno, std::generic_category(), "cannot read '" + path + "'" };
+            if (n == 0)
+                throw std::runtime_error{ "unexpected end of '" + path + "'" };
+            offset += std::size_t(n);
+        }
+        return owned_fn{}(std::move(result));
+    }
+};
+
+template <class T>
+struct mapped_binary_fn
+{
+    static_assert(std::is_trivially_copyable_v<T>, "mapped_binary requires a trivially copyable type");
+
+    auto operator()(const std::string& path, mmap_options options = {}) const
+    {
+        using result_type = owning_iterator<const T*, mapped_file>;
+
+        const auto file = std::make_shared<mapped_file>(path, options);
+        ::millrind::detail::check_binary_size<T>(file->size());
+
+        const auto b = reinterpret_cast<const T*>(file->data());
+        const auto e = b + file->size() / sizeof(T);
+        return make_range(result_type{ b, file }, result_type{ e, file });
+    }
+};
+
+}  // namespace detail
+
+static constexpr inline auto write_binary = pipeable{ detail::write_binary_fn{} };
+
+template <class T>
+static constexpr inline auto read_binary = detail::read_binary_fn<T>{};
+
+template <class T>
+static constexpr inline auto mapped_binary = detail::mapped_binary_fn<T>{};
+
+}  // namespace seq
+
+}  // namespace millrind
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "concurrent_queue.hpp"
+#include "iterator_facade.hpp"
+
+namespace millrind
+{
+enum class channel_wait
+{
+    block,
+    spin
+};
+
+template <class T>
+class channel;
+
+template <class T>
+class channel_iterator : public iterator_facade<channel_iterator<T>>
+{
+public:
+    channel_iterator() = default;
+
+    explicit channel_iterator(channel<T>& source)
+        : _channel{ &source }
+        , _current{ source.receive() }
+        , _index{ 0 }
+    {
+    }
+
+    channel_iterator(const channel_iterator&) = default;
+
+    T deref() const
+    {
+        return *_current;
+    }
+
+    void inc()
+    {
+        _current = _channel->receive();
+        ++_index;
+    }
+
+    bool is_equal(const channel_iterator& other) const
+    {
+        if (!_current || !other._current)
+            return !_current && !other._current;
+        return _channel == other._channel && _index == other._index;
+    }
+
+private:
+    channel<T>* _channel = nullptr;
+    std::optional<T> _current;
+    std::ptrdiff_t _index = 0;
+};
+
+template <class T>
+class channel
+{
+public:
+    explicit channel(std::size_t capacity, channel_wait wait = channel_wait::block)
+        : _queue{ capacity }
+        , _wait{ wait }
+        , _closed{ false }
+        , _waiting_senders{ 0 }
+        , _waiting_receivers{ 0 }
+    {
+    }
+
+    channel(const channel&) = delete;
+    channel& operator=(const channel&) = delete;
+
+    std::size_t capacity() const
+    {
+        return _queue.capacity();
+    }
+
+    template <class U>
+    bool try_send(U&& value)
+    {
+        if (closed() || !_queue.try_push(std::forward<U>(value)))
+            return false;
+        notify(_waiting_receivers, _not_empty);
+        return true;
+    }
+
+    template <class U>
+    bool send(U&& value)
+    {
+        detail::backoff backoff;
+        while (!closed())
+        {
+            if (_queue.try_push(std::forward<U>(value)))
+            {
+                notify(_waiting_receivers, _not_empty);
+                return true;
+            }
+            wait(backoff, _waiting_senders, _not_full, [this] { return closed() || !_queue.full(); });
+        }
+        return false;
+    }
+
+    std::optional<T> try_receive()
+    {
+        auto result = _queue.try_pop();
+        if (result)
+            notify(_waiting_senders, _not_full);
+        return result;
+    }
+
+    std::optional<T> receive()
+    {
+        detail::backoff backoff;
+        while (true)
+        {
+            if (auto result = try_receive())
+                return result;
+            if (closed())
+                return try_receive();
+            wait(backoff, _waiting_receivers, _not_empty, [this] { return closed() || !_queue.empty(); });
+        }
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard lock{ _mutex };
+            _closed.store(true, std::memory_order_seq_cst);
+        }
+        _not_empty.notify_all();
+        _not_full.notify_all();
+    }
+
+    bool closed() const
+    {
+        return _closed.load(std::memory_order_acquire);
+    }
+
+    channel_iterator<T> begin()
+    {
+        return channel_iterator<T>{ *this };
+    }
+
+    channel_iterator<T> end()
+    {
+        return channel_iterator<T>{};
+    }
+
+private:
+    void notify(std::atomic<std::size_t>& waiting, std::condition_variable& condition)
+    {
+        if (_wait == channel_wait::spin)
+            return;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard lock{ _mutex };
+            condition.notify_all();
+        }
+    }
+
+    template <class Pred>
+    void wait(detail::backoff& backoff, std::atomic<std::size_t>& waiting, std::condition_variable& condition, Pred ready)
+    {
+        if (_wait == channel_wait::spin)
+            return backoff.pause();
+
+        std::unique_lock lock{ _mutex };
+        waiting.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready())
+            condition.wait(lock);
+        waiting.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    mpmc_queue<T> _queue;
+    channel_wait _wait;
+    std::atomic<bool> _closed;
+    std::atomic<std::size_t> _waiting_senders;
+    std::atomic<std::size_t> _waiting_receivers;
+    std::mutex _mutex;
+    std::condition_variable _not_empty;
+    std::condition_variable _not_full;
+};
+
+}  // namespace millrind
+
+MILLRIND_INPUT_ITERATOR_TRAITS(::millrind::channel_iterator)
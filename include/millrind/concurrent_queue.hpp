@@ -0,0 +1,281 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace millrind
+{
+namespace detail
+{
+static constexpr inline std::size_t cache_line_size = 64;
+
+inline std::size_t round_up_to_power_of_two(std::size_t value)
+{
+    std::size_t result = 1;
+    while (result < value)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+
+class backoff
+{
+public:
+    void pause()
+    {
+        if (_count < spin_limit)
+        {
+            ++_count;
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds{ 50 });
+        }
+    }
+
+    void reset()
+    {
+        _count = 0;
+    }
+
+private:
+    static constexpr unsigned spin_limit = 64;
+
+    unsigned _count = 0;
+};
+
+}  // namespace detail
+
+template <class T>
+class mpmc_queue
+{
+public:
+    explicit mpmc_queue(std::size_t capacity)
+        : _cells{ new cell[detail::round_up_to_power_of_two(std::max<std::size_t>(capacity, 2))] }
+        , _mask{ detail::round_up_to_power_of_two(std::max<std::size_t>(capacity, 2)) - 1 }
+        , _enqueue_pos{ 0 }
+        , _dequeue_pos{ 0 }
+    {
+        for (std::size_t i = 0; i <= _mask; ++i)
+        {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    ~mpmc_queue()
+    {
+        while (try_pop())
+        {
+        }
+    }
+
+    std::size_t capacity() const
+    {
+        return _mask + 1;
+    }
+
+    template <class U>
+    bool try_push(U&& value)
+    {
+        auto pos = _enqueue_pos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& c = _cells[pos & _mask];
+            const auto sequence = c.sequence.load(std::memory_order_acquire);
+            const auto diff = std::intptr_t(sequence) - std::intptr_t(pos);
+            if (diff == 0)
+            {
+                if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    ::new (c.ptr()) T(std::forward<U>(value));
+                    c.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T& value)
+    {
+        if (auto result = try_pop())
+        {
+            value = std::move(*result);
+            return true;
+        }
+        return false;
+    }
+
+    std::optional<T> try_pop()
+    {
+        auto pos = _dequeue_pos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& c = _cells[pos & _mask];
+            const auto sequence = c.sequence.load(std::memory_order_acquire);
+            const auto diff = std::intptr_t(sequence) - std::intptr_t(pos + 1);
+            if (diff == 0)
+            {
+                if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    std::optional<T> result{ std::move(*c.ptr()) };
+                    c.ptr()->~T();
+                    c.sequence.store(pos + _mask + 1, std::memory_order_release);
+                    return result;
+                }
+            }
+            else if (diff < 0)
+            {
+                return std::nullopt;
+            }
+            else
+            {
+                pos = _dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool empty() const
+    {
+        return _dequeue_pos.load(std::memory_order_acquire) >= _enqueue_pos.load(std::memory_order_acquire);
+    }
+
+    bool full() const
+    {
+        const auto dequeue_pos = _dequeue_pos.load(std::memory_order_acquire);
+        return _enqueue_pos.load(std::memory_order_acquire) - dequeue_pos > _mask;
+    }
+
+private:
+    struct cell
+    {
+        std::atomic<std::size_t> sequence;
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+        T* ptr()
+        {
+            return std::launder(reinterpret_cast<T*>(&storage));
+        }
+    };
+
+    std::unique_ptr<cell[]> _cells;
+    std::size_t _mask;
+    alignas(detail::cache_line_size) std::atomic<std::size_t> _enqueue_pos;
+    alignas(detail::cache_line_size) std::atomic<std::size_t> _dequeue_pos;
+};
+
+template <class T>
+class spsc_queue
+{
+public:
+    explicit spsc_queue(std::size_t capacity)
+        : _cells{ new cell[detail::round_up_to_power_of_two(std::max<std::size_t>(capacity, 2))] }
+        , _mask{ detail::round_up_to_power_of_two(std::max<std::size_t>(capacity, 2)) - 1 }
+        , _head{ 0 }
+        , _cached_tail{ 0 }
+        , _tail{ 0 }
+        , _cached_head{ 0 }
+    {
+    }
+
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    ~spsc_queue()
+    {
+        while (try_pop())
+        {
+        }
+    }
+
+    std::size_t capacity() const
+    {
+        return _mask + 1;
+    }
+
+    template <class U>
+    bool try_push(U&& value)
+    {
+        const auto tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _cached_head > _mask)
+        {
+            _cached_head = _head.load(std::memory_order_acquire);
+            if (tail - _cached_head > _mask)
+                return false;
+        }
+        ::new (_cells[tail & _mask].ptr()) T(std::forward<U>(value));
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& value)
+    {
+        if (auto result = try_pop())
+        {
+            value = std::move(*result);
+            return true;
+        }
+        return false;
+    }
+
+    std::optional<T> try_pop()
+    {
+        const auto head = _head.load(std::memory_order_relaxed);
+        if (head == _cached_tail)
+        {
+            _cached_tail = _tail.load(std::memory_order_acquire);
+            if (head == _cached_tail)
+                return std::nullopt;
+        }
+        auto& c = _cells[head & _mask];
+        std::optional<T> result{ std::move(*c.ptr()) };
+        c.ptr()->~T();
+        _head.store(head + 1, std::memory_order_release);
+        return result;
+    }
+
+    bool empty() const
+    {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+
+private:
+    struct cell
+    {
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+        T* ptr()
+        {
+            return std::launder(reinterpret_cast<T*>(&storage));
+        }
+    };
+
+    std::unique_ptr<cell[]> _cells;
+    std::size_t _mask;
+    alignas(detail::cache_line_size) std::atomic<std::size_t> _head;
+    std::size_t _cached_tail;
+    alignas(detail::cache_line_size) std::atomic<std::size_t> _tail;
+    std::size_t _cached_head;
+};
+
+}  // namespace millrind
@@ -0,0 +1,347 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "functions.hpp"
+#include "iterator_facade.hpp"
+#include "pipeable.hpp"
+
+namespace millrind
+{
+namespace detail
+{
+struct default_hash
+{
+    template <class T>
+    std::size_t operator()(const T& item) const
+    {
+        return std::hash<T>{}(item);
+    }
+};
+
+inline std::uint64_t mix_hash(std::uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+template <class Value, class KeyOf, class Hash, class KeyEqual>
+class flat_hash_table
+{
+private:
+    enum : std::uint8_t
+    {
+        empty_slot = 0,
+        deleted_slot = 1,
+        full_slot = 0x80
+    };
+
+    static constexpr std::size_t min_capacity = 16;
+
+public:
+    using value_type = Value;
+    using key_type = std::decay_t<decltype(std::declval<KeyOf>()(std::declval<const Value&>()))>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+    template <class Table, class V>
+    class iterator_impl : public iterator_facade<iterator_impl<Table, V>>
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::remove_const_t<V>;
+        using reference = V&;
+        using pointer = V*;
+        using difference_type = std::ptrdiff_t;
+
+        iterator_impl() = default;
+
+        iterator_impl(Table* table, std::size_t index)
+            : _table{ table }
+            , _index{ index }
+        {
+            skip();
+        }
+
+        iterator_impl(const iterator_impl&) = default;
+
+        V& deref() const
+        {
+            return *_table->_slots[_index];
+        }
+
+        void inc()
+        {
+            ++_index;
+            skip();
+        }
+
+        bool is_equal(const iterator_impl& other) const
+        {
+            return _index == other._index;
+        }
+
+    private:
+        void skip()
+        {
+            while (_index < _table->_ctrl.size() && !(_table->_ctrl[_index] & full_slot))
+            {
+                ++_index;
+            }
+        }
+
+        Table* _table = nullptr;
+        std::size_t _index = 0;
+    };
+
+    using iterator = iterator_impl<flat_hash_table, Value>;
+    using const_iterator = iterator_impl<const flat_hash_table, const Value>;
+
+    explicit flat_hash_table(size_type capacity = 0, Hash hash = {}, KeyEqual key_equal = {})
+        : _ctrl{}
+        , _slots{}
+        , _size{ 0 }
+        , _used{ 0 }
+        , _hash{ std::move(hash) }
+        , _key_equal{ std::move(key_equal) }
+    {
+        reserve(capacity);
+    }
+
+    size_type size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    size_type capacity() const
+    {
+        return _ctrl.size();
+    }
+
+    iterator begin()
+    {
+        return { this, 0 };
+    }
+
+    iterator end()
+    {
+        return { this, _ctrl.size() };
+    }
+
+    const_iterator begin() const
+    {
+        return { this, 0 };
+    }
+
+    const_iterator end() const
+    {
+        return { this, _ctrl.size() };
+    }
+
+    void clear()
+    {
+        std::fill(std::begin(_ctrl), std::end(_ctrl), empty_slot);
+        std::fill(std::begin(_slots), std::end(_slots), std::nullopt);
+        _size = 0;
+        _used = 0;
+    }
+
+    void reserve(size_type count)
+    {
+        if (count * 4 > capacity() * 3)
+        {
+            rehash(count);
+        }
+    }
+
+    Value* find(const key_type& key)
+    {
+        const auto index = find_index(key);
+        return index ? std::addressof(*_slots[*index]) : nullptr;
+    }
+
+    const Value* find(const key_type& key) const
+    {
+        const auto index = find_index(key);
+        return index ? std::addressof(*_slots[*index]) : nullptr;
+    }
+
+    bool contains(const key_type& key) const
+    {
+        return find_index(key).has_value();
+    }
+
+    template <class Factory>
+    std::pair<Value*, bool> find_or_emplace(const key_type& key, Factory&& factory)
+    {
+        if ((_used + 1) * 4 > capacity() * 3)
+        {
+            rehash(_size + 1);
+        }
+
+        const auto h = mix_hash(_hash(key));
+        const auto tag = make_tag(h);
+        const auto mask = capacity() - 1;
+        std::optional<std::size_t> free_index;
+
+        for (auto index = h & mask;; index = (index + 1) & mask)
+        {
+            const auto ctrl = _ctrl[index];
+            if (ctrl == tag && _key_equal(KeyOf{}(*_slots[index]), key))
+            {
+                return { std::addressof(*_slots[index]), false };
+            }
+            else if (ctrl == deleted_slot)
+            {
+                if (!free_index)
+                    free_index = index;
+            }
+            else if (ctrl == empty_slot)
+            {
+                if (!free_index)
+                {
+                    free_index = index;
+                    ++_used;
+                }
+                break;
+            }
+        }
+
+        _ctrl[*free_index] = tag;
+        _slots[*free_index].emplace(std::invoke(std::forward<Factory>(factory)));
+        ++_size;
+        return { std::addressof(*_slots[*free_index]), true };
+    }
+
+    bool erase(const key_type& key)
+    {
+        if (const auto index = find_index(key))
+        {
+            _ctrl[*index] = deleted_slot;
+            _slots[*index].reset();
+            --_size;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    static std::uint8_t make_tag(std::uint64_t h)
+    {
+        return full_slot | static_cast<std::uint8_t>(h >> 57);
+    }
+
+    std::optional<std::size_t> find_index(const key_type& key) const
+    {
+        if (_size == 0)
+            return std::nullopt;
+
+        const auto h = mix_hash(_hash(key));
+        const auto tag = make_tag(h);
+        const auto mask = capacity() - 1;
+
+        for (auto index = h & mask;; index = (index + 1) & mask)
+        {
+            const auto ctrl = _ctrl[index];
+            if (ctrl == tag && _key_equal(KeyOf{}(*_slots[index]), key))
+                return index;
+            else if (ctrl == empty_slot)
+                return std::nullopt;
+        }
+    }
+
+    void rehash(size_type count)
+    {
+        auto new_capacity = min_capacity;
+        while (count * 4 > new_capacity * 3)
+        {
+            new_capacity *= 2;
+        }
+
+        auto old_ctrl = std::exchange(_ctrl, std::vector<std::uint8_t>(new_capacity, empty_slot));
+        auto old_slots = std::exchange(_slots, std::vector<std::optional<Value>>(new_capacity));
+        const auto mask = new_capacity - 1;
+
+        for (std::size_t i = 0; i < old_ctrl.size(); ++i)
+        {
+            if (old_ctrl[i] & full_slot)
+            {
+                const auto h = mix_hash(_hash(KeyOf{}(*old_slots[i])));
+                auto index = h & mask;
+                while (_ctrl[index] != empty_slot)
+                {
+                    index = (index + 1) & mask;
+                }
+                _ctrl[index] = make_tag(h);
+                _slots[index] = std::move(old_slots[i]);
+            }
+        }
+        _used = _size;
+    }
+
+    std::vector<std::uint8_t> _ctrl;
+    std::vector<std::optional<Value>> _slots;
+    size_type _size;
+    size_type _used;
+    Hash _hash;
+    KeyEqual _key_equal;
+};
+
+}  // namespace detail
+
+template <class Key, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class flat_hash_set : public detail::flat_hash_table<Key, identity, Hash, KeyEqual>
+{
+private:
+    using base_type = detail::flat_hash_table<Key, identity, Hash, KeyEqual>;
+
+public:
+    using base_type::base_type;
+
+    bool insert(Key key)
+    {
+        return this->find_or_emplace(key, [&]() -> Key&& { return std::move(key); }).second;
+    }
+};
+
+template <class Key, class Mapped, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class flat_hash_map : public detail::flat_hash_table<std::pair<Key, Mapped>, detail::element_fn<0>, Hash, KeyEqual>
+{
+private:
+    using base_type = detail::flat_hash_table<std::pair<Key, Mapped>, detail::element_fn<0>, Hash, KeyEqual>;
+
+public:
+    using mapped_type = Mapped;
+
+    using base_type::base_type;
+
+    template <class... Args>
+    std::pair<std::pair<Key, Mapped>*, bool> try_emplace(const Key& key, Args&&... args)
+    {
+        return this->find_or_emplace(key, [&]() {
+            return std::pair<Key, Mapped>{ std::piecewise_construct,
+                                           std::forward_as_tuple(key),
+                                           std::forward_as_tuple(std::forward<Args>(args)...) };
+        });
+    }
+
+    Mapped& operator[](const Key& key)
+    {
+        return try_emplace(key).first->second;
+    }
+};
+
+}  // namespace millrind
\ No newline at end of file
@@ -1,11 +1,31 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <charconv>
+#include <iterator>
+#include <limits>
 #include <iostream>
 #include <sstream>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
 
-#include "output.hpp"
+#include "type_traits.hpp"
+
+#define MILLRIND_FMT(text)                                   \
+    [] {                                                     \
+        struct source                                        \
+        {                                                    \
+            static constexpr std::string_view value()        \
+            {                                                \
+                return text;                                 \
+            }                                                \
+        };                                                   \
+        return ::millrind::detail::static_format<source>{};  \
+    }()
 
 namespace millrind
 {
@@ -19,107 +39,605 @@ struct format_error : std::runtime_error
     }
 };
 
-using argument_extractor = std::function<void(std::ostream&, int, std::string_view)>;
+constexpr int parse_int(std::string_view txt)
+{
+    int result = 0;
+    for (char c : txt)
+    {
+        if (c < '0' || c > '9')
+            throw format_error{ "invalid argument index" };
+        result = result * 10 + (c - '0');
+    }
+    return result;
+}
+
+struct format_spec
+{
+    char fill = ' ';
+    char align = '\0';
+    bool zero_pad = false;
+    int width = 0;
+    int precision = -1;
+    char type = '\0';
+};
 
-inline std::string_view make_string_view(std::string_view::iterator b, std::string_view::iterator e)
+constexpr bool is_format_align(char c)
 {
-    if (b < e)
-        return { std::addressof(*b), std::string_view::size_type(e - b) };
-    else
-        return {};
+    return c == '<' || c == '>' || c == '^';
 }
 
-inline void apply_format_spec(std::ostream& os, std::string_view fmt)
+constexpr bool is_format_type(char c)
 {
+    return c == 'd' || c == 'x' || c == 'X' || c == 'o' || c == 'b' || c == 'e' || c == 'f' || c == 'g' || c == 's';
 }
 
-inline int parse_int(std::string_view txt)
+constexpr format_spec parse_spec(std::string_view txt)
 {
-    int result = 0;
-    for (char c : txt)
+    format_spec result{};
+    std::size_t pos = 0;
+
+    if (txt.size() >= 2 && is_format_align(txt[1]))
     {
-        result = result * 10 + (c - '0');
+        result.fill = txt[0];
+        result.align = txt[1];
+        pos = 2;
+    }
+    else if (!txt.empty() && is_format_align(txt[0]))
+    {
+        result.align = txt[0];
+        pos = 1;
+    }
+
+    if (pos < txt.size() && txt[pos] == '0')
+    {
+        result.zero_pad = true;
+        ++pos;
+    }
+
+    const auto read_number = [&]() {
+        const auto start = pos;
+        while (pos < txt.size() && txt[pos] >= '0' && txt[pos] <= '9')
+        {
+            ++pos;
+        }
+        return txt.substr(start, pos - start);
+    };
+
+    if (const auto width = read_number(); !width.empty())
+        result.width = parse_int(width);
+
+    if (pos < txt.size() && txt[pos] == '.')
+    {
+        ++pos;
+        const auto precision = read_number();
+        if (precision.empty())
+            throw format_error{ "missing precision" };
+        result.precision = parse_int(precision);
     }
+
+    if (pos < txt.size() && is_format_type(txt[pos]))
+        result.type = txt[pos++];
+
+    if (pos != txt.size())
+        throw format_error{ "invalid format spec" };
+
     return result;
 }
 
-template <class T>
-void write_arg(std::ostream& os, std::string_view fmt, const T& item)
+struct format_segment
 {
-    apply_format_spec(os, fmt);
-    os << item;
+    std::size_t begin = 0;
+    std::size_t size = 0;
+    int arg = -1;
+    format_spec spec = {};
+};
+
+template <class Func>
+constexpr void parse_format(std::string_view fmt, Func&& func)
+{
+    std::size_t literal = 0;
+    std::size_t pos = 0;
+    int arg_index = 0;
+    while (pos < fmt.size())
+    {
+        const char c = fmt[pos];
+        if (c != '{' && c != '}')
+        {
+            ++pos;
+            continue;
+        }
+
+        if (pos + 1 < fmt.size() && fmt[pos + 1] == c)
+        {
+            func(format_segment{ literal, pos + 1 - literal });
+            pos += 2;
+            literal = pos;
+            continue;
+        }
+
+        if (c == '}')
+            throw format_error{ "unexpected closing bracket" };
+
+        const auto closing = fmt.find('}', pos + 1);
+        if (closing == std::string_view::npos)
+            throw format_error{ "unclosed bracket" };
+
+        if (pos > literal)
+            func(format_segment{ literal, pos - literal });
+
+        const auto field = fmt.substr(pos + 1, closing - pos - 1);
+        const auto colon = field.find(':');
+        const auto index_part = field.substr(0, colon);
+        const auto spec = colon != std::string_view::npos ? parse_spec(field.substr(colon + 1)) : format_spec{};
+        func(format_segment{ 0, 0, !index_part.empty() ? parse_int(index_part) : arg_index, spec });
+
+        ++arg_index;
+        pos = closing + 1;
+        literal = pos;
+    }
+
+    if (literal < fmt.size())
+        func(format_segment{ literal, fmt.size() - literal });
 }
 
-inline void write_args(std::ostream& os, int index, std::string_view fmt)
+constexpr std::size_t count_segments(std::string_view fmt)
 {
-    throw format_error{ "Invalid index" };
+    std::size_t result = 0;
+    parse_format(fmt, [&](const format_segment&) { ++result; });
+    return result;
 }
 
-template <class T, class... Args>
-void write_args(std::ostream& os, int index, std::string_view fmt, const T& arg, const Args&... args)
+template <std::size_t N>
+constexpr auto make_segments(std::string_view fmt) -> std::array<format_segment, N>
 {
-    if (index == 0)
-        write_arg(os, fmt, arg);
-    else
-        write_args(os, index - 1, fmt, args...);
+    std::array<format_segment, N> result{};
+    std::size_t index = 0;
+    parse_format(fmt, [&](const format_segment& segment) { result[index++] = segment; });
+    return result;
+}
+
+struct string_appender
+{
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    std::string* str;
+
+    string_appender& operator*()
+    {
+        return *this;
+    }
+
+    string_appender& operator++()
+    {
+        return *this;
+    }
+
+    string_appender& operator++(int)
+    {
+        return *this;
+    }
+
+    string_appender& operator=(char c)
+    {
+        str->push_back(c);
+        return *this;
+    }
+};
+
+struct counting_output_iterator
+{
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    std::size_t count = 0;
+
+    counting_output_iterator& operator*()
+    {
+        return *this;
+    }
+
+    counting_output_iterator& operator++()
+    {
+        return *this;
+    }
+
+    counting_output_iterator& operator++(int)
+    {
+        return *this;
+    }
+
+    counting_output_iterator& operator=(char)
+    {
+        ++count;
+        return *this;
+    }
+};
+
+template <class Out>
+struct truncating_output_iterator
+{
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    Out out;
+    std::size_t limit;
+    std::size_t count = 0;
+
+    truncating_output_iterator& operator*()
+    {
+        return *this;
+    }
+
+    truncating_output_iterator& operator++()
+    {
+        return *this;
+    }
+
+    truncating_output_iterator& operator++(int)
+    {
+        return *this;
+    }
+
+    truncating_output_iterator& operator=(char c)
+    {
+        if (count++ < limit)
+            *out++ = c;
+        return *this;
+    }
+};
+
+template <class Out>
+Out put(Out out, std::string_view txt)
+{
+    return std::copy(txt.begin(), txt.end(), out);
+}
+
+inline string_appender put(string_appender out, std::string_view txt)
+{
+    out.str->append(txt);
+    return out;
+}
+
+inline counting_output_iterator put(counting_output_iterator out, std::string_view txt)
+{
+    out.count += txt.size();
+    return out;
+}
+
+template <class Out>
+Out put_fill(Out out, std::size_t count, char c)
+{
+    return std::fill_n(out, count, c);
+}
+
+inline string_appender put_fill(string_appender out, std::size_t count, char c)
+{
+    out.str->append(count, c);
+    return out;
+}
+
+inline counting_output_iterator put_fill(counting_output_iterator out, std::size_t count, char)
+{
+    out.count += count;
+    return out;
+}
+
+inline void apply_format_spec(std::ostream& os, const format_spec& spec)
+{
+    if (spec.precision >= 0)
+        os.precision(spec.precision);
+
+    switch (spec.type)
+    {
+        case 'x': os << std::hex; break;
+        case 'X': os << std::hex << std::uppercase; break;
+        case 'o': os << std::oct; break;
+        case 'e': os << std::scientific; break;
+        case 'f': os << std::fixed; break;
+        default: break;
+    }
 }
 
-inline void format_text(std::ostream& os, std::string_view txt)
+template <class Out>
+Out write_padded(Out out, const format_spec& spec, std::string_view body, bool numeric)
 {
-    os << txt;
+    if (spec.width <= int(body.size()))
+        return put(out, body);
+
+    const auto padding = std::size_t(spec.width) - body.size();
+    if (numeric && spec.zero_pad && spec.align == '\0')
+    {
+        const auto sign = !body.empty() && (body[0] == '-' || body[0] == '+') ? 1 : 0;
+        out = put(out, body.substr(0, sign));
+        out = put_fill(out, padding, '0');
+        return put(out, body.substr(sign));
+    }
+
+    const auto align = spec.align != '\0' ? spec.align : numeric ? '>' : '<';
+    const auto before = align == '>' ? padding : align == '^' ? padding / 2 : 0;
+    out = put_fill(out, before, spec.fill);
+    out = put(out, body);
+    return put_fill(out, padding - before, spec.fill);
 }
 
-inline void format_arg(std::ostream& os, std::string_view fmt, int arg_index, const argument_extractor& arg_extractor)
+template <class T>
+constexpr bool is_character_v = std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>;
+
+template <class T>
+std::to_chars_result integer_to_chars(char* b, char* e, const format_spec& spec, T item)
 {
-    const auto colon = std::find(fmt.begin(), fmt.end(), ':');
-    const auto index_part = make_string_view(fmt.begin(), colon);
-    const auto fmt_part = make_string_view(colon != fmt.end() ? colon + 1 : colon, fmt.end());
+    switch (spec.type)
+    {
+        case 'x':
+        case 'X': return std::to_chars(b, e, item, 16);
+        case 'o': return std::to_chars(b, e, item, 8);
+        case 'b': return std::to_chars(b, e, item, 2);
+        default: return std::to_chars(b, e, item);
+    }
+}
 
-    const auto actual_index = !index_part.empty()
-                                  ? parse_int(index_part)
-                                  : arg_index;
+static constexpr inline int default_float_precision = 6;
+
+template <class T>
+std::to_chars_result floating_to_chars(char* b, char* e, const format_spec& spec, T item)
+{
+    const auto fmt = spec.type == 'e'                      ? std::chars_format::scientific
+                     : spec.type == 'f'                    ? std::chars_format::fixed
+                     : spec.type == 'x' || spec.type == 'X' ? std::chars_format::hex
+                                                            : std::chars_format::general;
+    if (spec.precision >= 0)
+        return std::to_chars(b, e, item, fmt, spec.precision);
+    if (fmt == std::chars_format::hex)
+        return std::to_chars(b, e, item, fmt);
+    return std::to_chars(b, e, item, fmt, default_float_precision);
+}
 
-    arg_extractor(os, actual_index, fmt_part);
+template <class Out, class T>
+Out write_stream(Out out, const format_spec& spec, const T& item)
+{
+    std::ostringstream os;
+    apply_format_spec(os, spec);
+    os << item;
+    return write_padded(out, spec, os.str(), std::is_arithmetic_v<T>);
 }
 
-inline void do_format(std::ostream& os, std::string_view fmt, int arg_index, const argument_extractor& arg_extractor)
+template <class Out, class T>
+Out write_arg(Out out, const format_spec& spec, const T& item)
 {
-    const auto bracket = std::find_if(fmt.begin(), fmt.end(), [](char c) { return c == '{' || c == '}'; });
-    if (bracket == fmt.end())
+    if constexpr (std::is_convertible_v<const T&, std::string_view>)
     {
-        return format_text(os, fmt);
+        const auto txt = std::string_view{ item };
+        return write_padded(out, spec, spec.precision >= 0 ? txt.substr(0, spec.precision) : txt, false);
     }
-    else if (bracket + 1 != fmt.end() && bracket[0] == bracket[1])
+    else if constexpr (is_character_v<T>)
     {
-        format_text(os, make_string_view(fmt.begin(), bracket + 1));
-        return do_format(os, make_string_view(bracket + 2, fmt.end()), arg_index, arg_extractor);
+        const auto c = static_cast<char>(item);
+        if (spec.type == '\0' || spec.type == 's')
+            return write_padded(out, spec, std::string_view{ &c, 1 }, false);
+        return write_arg(out, spec, int(item));
     }
-    else if (bracket[0] == '{')
+    else if constexpr (std::is_same_v<T, bool>)
     {
-        const auto closing_bracket = std::find(bracket + 1, fmt.end(), '}');
-        if (closing_bracket == fmt.end())
+        return write_arg(out, spec, int(item));
+    }
+    else if constexpr (std::is_integral_v<T> || std::is_floating_point_v<T>)
+    {
+        char buffer[128];
+        std::to_chars_result result;
+        if constexpr (std::is_integral_v<T>)
         {
-            throw format_error{ "unclosed bracket" };
+            result = spec.type == 'e' || spec.type == 'f' || spec.type == 'g'
+                         ? floating_to_chars(std::begin(buffer), std::end(buffer), spec, double(item))
+                         : integer_to_chars(std::begin(buffer), std::end(buffer), spec, item);
+        }
+        else
+        {
+            result = floating_to_chars(std::begin(buffer), std::end(buffer), spec, item);
         }
-        format_text(os, make_string_view(fmt.begin(), bracket));
-        format_arg(os, make_string_view(bracket + 1, closing_bracket), arg_index, arg_extractor);
-        return do_format(os, make_string_view(closing_bracket + 1, fmt.end()), arg_index + 1, arg_extractor);
+
+        if (result.ec != std::errc{})
+            return write_stream(out, spec, item);
+        if (spec.type == 'X')
+            std::transform(std::begin(buffer), result.ptr, std::begin(buffer), [](char c) { return c >= 'a' && c <= 'f' ? char(c - 'a' + 'A') : c; });
+        return write_padded(out, spec, std::string_view{ buffer, std::size_t(result.ptr - buffer) }, true);
+    }
+    else
+    {
+        return write_stream(out, spec, item);
+    }
+}
+
+template <class Out>
+struct format_argument
+{
+    using writer_type = Out (*)(Out, const format_spec&, const void*);
+
+    const void* value;
+    writer_type writer;
+
+    Out write(Out out, const format_spec& spec) const
+    {
+        return writer(std::move(out), spec, value);
     }
-    throw format_error{ "unexpected opening bracket" };
+};
+
+template <class Out, class T>
+format_argument<Out> make_format_argument(const T& item)
+{
+    return { std::addressof(item), [](Out out, const format_spec& spec, const void* value) {
+                return write_arg(std::move(out), spec, *static_cast<const T*>(value));
+            } };
+}
+
+template <class Out>
+Out write_format_segment(Out out, std::string_view text, const format_segment& segment, const format_argument<Out>* args, std::size_t count)
+{
+    if (segment.arg < 0)
+        return put(out, text.substr(segment.begin, segment.size));
+    if (segment.arg >= int(count))
+        throw format_error{ "Invalid index" };
+    return args[segment.arg].write(out, segment.spec);
+}
+
+template <class Out, class... Args>
+Out vformat_to(Out out, std::string_view fmt, const Args&... args)
+{
+    const std::array<format_argument<Out>, sizeof...(Args)> arguments{ make_format_argument<Out>(args)... };
+    parse_format(fmt, [&](const format_segment& segment) {
+        out = write_format_segment(out, fmt, segment, arguments.data(), arguments.size());
+    });
+    return out;
 }
 
+template <class Source>
+struct static_format
+{
+    static constexpr std::string_view text = Source::value();
+    static constexpr auto segments = make_segments<count_segments(text)>(text);
+
+    static constexpr int arg_count()
+    {
+        int result = 0;
+        for (const auto& segment : segments)
+        {
+            result = std::max(result, segment.arg + 1);
+        }
+        return result;
+    }
+
+    static constexpr std::size_t literal_size()
+    {
+        std::size_t result = 0;
+        for (const auto& segment : segments)
+        {
+            result += segment.size;
+        }
+        return result;
+    }
+
+    template <class... Args>
+    std::string operator()(const Args&... args) const
+    {
+        std::string result;
+        result.reserve(literal_size());
+        write(string_appender{ &result }, args...);
+        return result;
+    }
+
+    template <class Out, class... Args>
+    Out write(Out out, const Args&... args) const
+    {
+        static_assert(arg_count() <= int(sizeof...(Args)), "format string refers to a missing argument");
+
+        return write_segments(std::move(out), std::make_index_sequence<segments.size()>{}, std::forward_as_tuple(args...));
+    }
+
+private:
+    template <class Out, class Tuple, std::size_t... I>
+    static Out write_segments(Out out, std::index_sequence<I...>, const Tuple& args)
+    {
+        ((out = write_segment<I>(std::move(out), args)), ...);
+        return out;
+    }
+
+    template <std::size_t I, class Out, class Tuple>
+    static Out write_segment(Out out, const Tuple& args)
+    {
+        constexpr auto segment = segments[I];
+        if constexpr (segment.arg < 0)
+            return put(std::move(out), text.substr(segment.begin, segment.size));
+        else
+            return write_arg(std::move(out), segment.spec, std::get<segment.arg>(args));
+    }
+};
+
 template <class... Args>
 std::string format(std::string_view fmt, const Args&... args)
 {
-    const argument_extractor arg_extractor = [&](std::ostream& os, int index, std::string_view f) {
-        write_args(os, index, f, args...);
-    };
+    std::string result;
+    vformat_to(string_appender{ &result }, fmt, args...);
+    return result;
+}
+
+template <class Out>
+struct format_to_n_result
+{
+    Out out;
+    std::size_t size;
+};
+
+template <class Out, class Format, class... Args>
+Out format_to(Out out, const Format& fmt, const Args&... args)
+{
+    if constexpr (std::is_convertible_v<const Format&, std::string_view>)
+        return vformat_to(std::move(out), std::string_view{ fmt }, args...);
+    else
+        return fmt.write(std::move(out), args...);
+}
+
+template <class Out, class Format, class... Args>
+auto format_to_n(Out out, std::size_t n, const Format& fmt, const Args&... args) -> format_to_n_result<Out>
+{
+    const auto result = format_to(truncating_output_iterator<Out>{ std::move(out), n }, fmt, args...);
+    return { result.out, result.count };
+}
+
+template <class Format, class... Args>
+std::size_t formatted_size(const Format& fmt, const Args&... args)
+{
+    return format_to(counting_output_iterator{}, fmt, args...).count;
+}
+
+template <class T>
+constexpr bool is_directly_formatted_v = std::is_convertible_v<const T&, std::string_view> || std::is_arithmetic_v<T>;
 
-    std::stringstream ss;
-    do_format(ss, fmt, 0, arg_extractor);
-    return ss.str();
+template <class T>
+std::size_t str_size_bound(const T& item)
+{
+    if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        return std::string_view{ item }.size();
+    else if constexpr (is_character_v<T> || std::is_same_v<T, bool>)
+        return 1;
+    else if constexpr (std::is_integral_v<T>)
+        return std::numeric_limits<T>::digits10 + 2;
+    else if constexpr (std::is_floating_point_v<T>)
+        return std::numeric_limits<T>::max_digits10 + 8;
+    else
+        return 0;
 }
 
+struct str_append_fn
+{
+    template <class... Args>
+    std::string& operator()(std::string& out, const Args&... args) const
+    {
+        out.reserve(out.size() + (str_size_bound(args) + ... + 0));
+        (write_arg(string_appender{ &out }, format_spec{}, args), ...);
+        return out;
+    }
+};
+
+struct str_cat_fn
+{
+    template <class... Args>
+    std::string operator()(const Args&... args) const
+    {
+        std::string result;
+        str_append_fn{}(result, args...);
+        return result;
+    }
+};
+
 struct format_proxy_t
 {
     std::string_view fmt;
@@ -133,7 +651,70 @@ struct format_proxy_t
 
 }  // namespace detail
 
+class compiled_format
+{
+public:
+    explicit compiled_format(std::string_view fmt)
+        : _text{ fmt }
+        , _segments{}
+        , _arg_count{ 0 }
+        , _literal_size{ 0 }
+    {
+        detail::parse_format(_text, [&](const detail::format_segment& segment) {
+            _segments.push_back(segment);
+            _arg_count = std::max(_arg_count, segment.arg + 1);
+            _literal_size += segment.size;
+        });
+    }
+
+    const std::string& text() const
+    {
+        return _text;
+    }
+
+    int arg_count() const
+    {
+        return _arg_count;
+    }
+
+    template <class... Args>
+    std::string operator()(const Args&... args) const
+    {
+        std::string result;
+        result.reserve(_literal_size);
+        write(detail::string_appender{ &result }, args...);
+        return result;
+    }
+
+    template <class Out, class... Args>
+    Out write(Out out, const Args&... args) const
+    {
+        const std::array<detail::format_argument<Out>, sizeof...(Args)> arguments{ detail::make_format_argument<Out>(args)... };
+        if (_arg_count > int(arguments.size()))
+            throw detail::format_error{ "Invalid index" };
+
+        for (const auto& segment : _segments)
+        {
+            out = detail::write_format_segment(std::move(out), _text, segment, arguments.data(), arguments.size());
+        }
+        return out;
+    }
+
+private:
+    std::string _text;
+    std::vector<detail::format_segment> _segments;
+    int _arg_count;
+    std::size_t _literal_size;
+};
+
 using detail::format;
+using detail::format_to;
+using detail::format_to_n;
+using detail::format_to_n_result;
+using detail::formatted_size;
+
+static constexpr inline auto str_cat = detail::str_cat_fn{};
+static constexpr inline auto str_append = detail::str_append_fn{};
 
 namespace literals
 {
@@ -265,6 +265,19 @@ constexpr bool is_random_access = has_advance_v<Iter> && (has_distance_to_v<Iter
 template <class Iter>
 constexpr bool is_bidirectional = (has_inc_v<Iter> && has_dec_v<Iter>) || has_advance_v<Iter>;
 
+template <class T>
+constexpr bool is_single_pass = is_detected_v<input_iterator, T> && !is_detected_v<forward_iterator, T>;
+
+template <class Iter>
+struct has_single_pass_base : std::false_type
+{
+};
+
+template <template <class...> class Tmpl, class... Args>
+struct has_single_pass_base<Tmpl<Args...>> : std::bool_constant<(is_single_pass<Args> || ...)>
+{
+};
+
 }  // namespace detail
 
 template <class Iter>
@@ -276,9 +289,12 @@ struct iterator_traits
     using value_type = std::decay_t<reference>;
     using difference_type = typename detail::difference_type_impl<Iter>::type;
     using iterator_category = std::conditional_t<
-        detail::is_random_access<Iter>,
-        std::random_access_iterator_tag,
-        std::conditional_t<detail::is_bidirectional<Iter>, std::bidirectional_iterator_tag, std::forward_iterator_tag>>;
+        detail::has_single_pass_base<Iter>::value,
+        std::input_iterator_tag,
+        std::conditional_t<
+            detail::is_random_access<Iter>,
+            std::random_access_iterator_tag,
+            std::conditional_t<detail::is_bidirectional<Iter>, std::bidirectional_iterator_tag, std::forward_iterator_tag>>>;
 };
 
 }  // namespace millrind
@@ -291,3 +307,13 @@ struct iterator_traits
     {                                                                                  \
     };                                                                                 \
     }
+
+#define MILLRIND_INPUT_ITERATOR_TRAITS(iter)                                           \
+    namespace std                                                                      \
+    {                                                                                  \
+    template <class... Args>                                                           \
+    struct iterator_traits<iter<Args...>> : ::millrind::iterator_traits<iter<Args...>> \
+    {                                                                                  \
+        using iterator_category = std::input_iterator_tag;                             \
+    };                                                                                 \
+    }
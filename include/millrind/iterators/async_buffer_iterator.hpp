@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "../concurrent_queue.hpp"
+#include "../iterator_facade.hpp"
+#include "../type_traits.hpp"
+
+namespace millrind
+{
+namespace detail
+{
+template <class Iter>
+class async_buffer_state
+{
+public:
+    using value_type = iter_value_t<Iter>;
+
+    async_buffer_state(Iter begin, Iter end, std::size_t capacity)
+        : _begin{ std::move(begin) }
+        , _end{ std::move(end) }
+        , _queue{ capacity }
+        , _done{ false }
+        , _cancelled{ false }
+        , _error{}
+        , _thread{ [this] { run(); } }
+    {
+    }
+
+    async_buffer_state(const async_buffer_state&) = delete;
+    async_buffer_state& operator=(const async_buffer_state&) = delete;
+
+    ~async_buffer_state()
+    {
+        _cancelled.store(true, std::memory_order_release);
+        _thread.join();
+    }
+
+    std::optional<value_type> pop()
+    {
+        backoff wait;
+        while (true)
+        {
+            if (auto item = _queue.try_pop())
+                return item;
+            if (_done.load(std::memory_order_acquire))
+            {
+                if (auto item = _queue.try_pop())
+                    return item;
+                if (_error)
+                    std::rethrow_exception(std::exchange(_error, nullptr));
+                return std::nullopt;
+            }
+            wait.pause();
+        }
+    }
+
+private:
+    void run()
+    {
+        try
+        {
+            for (auto it = _begin; it != _end; ++it)
+            {
+                auto&& item = *it;
+                backoff wait;
+                while (!_queue.try_push(std::forward<decltype(item)>(item)))
+                {
+                    if (_cancelled.load(std::memory_order_acquire))
+                        return;
+                    wait.pause();
+                }
+                if (_cancelled.load(std::memory_order_acquire))
+                    return;
+            }
+        }
+        catch (...)
+        {
+            _error = std::current_exception();
+        }
+        _done.store(true, std::memory_order_release);
+    }
+
+    Iter _begin;
+    Iter _end;
+    spsc_queue<value_type> _queue;
+    std::atomic<bool> _done;
+    std::atomic<bool> _cancelled;
+    std::exception_ptr _error;
+    std::thread _thread;
+};
+
+}  // namespace detail
+
+template <class Iter>
+class async_buffer_iterator : public iterator_facade<async_buffer_iterator<Iter>>
+{
+private:
+    using state_type = detail::async_buffer_state<Iter>;
+    using value_type = typename state_type::value_type;
+
+public:
+    async_buffer_iterator() = default;
+
+    explicit async_buffer_iterator(std::shared_ptr<state_type> state)
+        : _state{ std::move(state) }
+        , _current{ _state->pop() }
+        , _index{ 0 }
+    {
+    }
+
+    async_buffer_iterator(const async_buffer_iterator&) = default;
+
+    value_type deref() const
+    {
+        return *_current;
+    }
+
+    void inc()
+    {
+        _current = _state->pop();
+        ++_index;
+    }
+
+    bool is_equal(const async_buffer_iterator& other) const
+    {
+        if (!_current || !other._current)
+            return !_current && !other._current;
+        return _state == other._state && _index == other._index;
+    }
+
+private:
+    std::shared_ptr<state_type> _state;
+    std::optional<value_type> _current;
+    std::ptrdiff_t _index = 0;
+};
+
+}  // namespace millrind
+
+MILLRIND_INPUT_ITERATOR_TRAITS(::millrind::async_buffer_iterator)
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory>
+
+#include "../flat_hash.hpp"
+#include "../iterator_facade.hpp"
+#include "default_constructible_func.hpp"
+
+namespace millrind
+{
+template <class Proj, class Set, class Erase, class Iter>
+class hash_filter_iterator : public iterator_facade<hash_filter_iterator<Proj, Set, Erase, Iter>>
+{
+public:
+    hash_filter_iterator() = default;
+
+    hash_filter_iterator(Proj proj, std::shared_ptr<Set> set, Iter iter, Iter end)
+        : _proj{ std::move(proj) }
+        , _set{ std::move(set) }
+        , _iter{ std::move(iter) }
+        , _end{ std::move(end) }
+    {
+        update();
+        _initial = std::move(_set);
+    }
+
+    hash_filter_iterator(const hash_filter_iterator&) = default;
+
+    decltype(auto) deref() const
+    {
+        return *_iter;
+    }
+
+    void inc()
+    {
+        if (!_set)
+            _set = std::make_shared<Set>(*_initial);
+        ++_iter;
+        update();
+    }
+
+    bool is_equal(const hash_filter_iterator& other) const
+    {
+        return _iter == other._iter;
+    }
+
+private:
+    void update()
+    {
+        while (_iter != _end && !accept(call(_proj, *_iter)))
+        {
+            ++_iter;
+        }
+    }
+
+    template <class Key>
+    bool accept(Key&& key)
+    {
+        if constexpr (Erase::value)
+            return _set->erase(key);
+        else
+            return _set->insert(std::forward<Key>(key));
+    }
+
+    default_constructible_func<Proj> _proj;
+    std::shared_ptr<const Set> _initial;
+    std::shared_ptr<Set> _set;
+    Iter _iter;
+    Iter _end;
+};
+
+}  // namespace millrind
+
+MILLRIND_INPUT_ITERATOR_TRAITS(::millrind::hash_filter_iterator)
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <vector>
+
+#include "../iterator_facade.hpp"
+#include "../iterator_range.hpp"
+#include "default_constructible_func.hpp"
+
+namespace millrind
+{
+template <class Compare, class Iter>
+class merge_iterator : public iterator_facade<merge_iterator<Compare, Iter>>
+{
+public:
+    merge_iterator() = default;
+
+    merge_iterator(Compare compare, std::vector<iterator_range<Iter>> sources)
+        : _compare{ std::move(compare) }
+        , _sources{ std::move(sources) }
+        , _tree(_sources.size())
+        , _index{ 0 }
+    {
+        build();
+    }
+
+    merge_iterator(const merge_iterator&) = default;
+
+    decltype(auto) deref() const
+    {
+        return *std::begin(_sources[_tree[0]]);
+    }
+
+    void inc()
+    {
+        auto winner = _tree[0];
+        _sources[winner] = make_range(std::next(std::begin(_sources[winner])), std::end(_sources[winner]));
+        replay(winner);
+        ++_index;
+    }
+
+    bool is_equal(const merge_iterator& other) const
+    {
+        return done() == other.done() && (done() || _index == other._index);
+    }
+
+private:
+    bool done() const
+    {
+        return _tree.empty() || _sources[_tree[0]].empty();
+    }
+
+    bool beats(std::size_t lhs, std::size_t rhs) const
+    {
+        if (_sources[lhs].empty())
+            return false;
+        if (_sources[rhs].empty())
+            return true;
+
+        const auto& l = *std::begin(_sources[lhs]);
+        const auto& r = *std::begin(_sources[rhs]);
+        return call(_compare, l, r) || (lhs < rhs && !call(_compare, r, l));
+    }
+
+    void build()
+    {
+        const auto k = _sources.size();
+        if (k == 0)
+            return;
+
+        std::vector<std::size_t> winners(k);
+        for (auto node = k - 1; node > 0; --node)
+        {
+            const auto left = child_winner(winners, 2 * node);
+            const auto right = child_winner(winners, 2 * node + 1);
+            const auto left_wins = beats(left, right);
+            winners[node] = left_wins ? left : right;
+            _tree[node] = left_wins ? right : left;
+        }
+        _tree[0] = k > 1 ? winners[1] : 0;
+    }
+
+    std::size_t child_winner(const std::vector<std::size_t>& winners, std::size_t node) const
+    {
+        return node >= _sources.size() ? node - _sources.size() : winners[node];
+    }
+
+    void replay(std::size_t winner)
+    {
+        for (auto node = (winner + _sources.size()) / 2; node > 0; node /= 2)
+        {
+            if (beats(_tree[node], winner))
+                std::swap(_tree[node], winner);
+        }
+        _tree[0] = winner;
+    }
+
+    default_constructible_func<Compare> _compare;
+    std::vector<iterator_range<Iter>> _sources;
+    std::vector<std::size_t> _tree;
+    std::ptrdiff_t _index;
+};
+
+}  // namespace millrind
+
+MILLRIND_ITERATOR_TRAITS(::millrind::merge_iterator)
@@ -71,6 +71,11 @@ private:
     std::shared_ptr<Container> _container;
 };
 
+template <class Iter, class Container>
+struct is_contiguous_iterator<owning_iterator<Iter, Container>> : is_contiguous_iterator<Iter>
+{
+};
+
 }  // namespace millrind
 
 MILLRIND_ITERATOR_TRAITS(::millrind::owning_iterator)
\ No newline at end of file
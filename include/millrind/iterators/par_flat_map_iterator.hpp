@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "../iterator_facade.hpp"
+#include "../pipeable.hpp"
+#include "../type_traits.hpp"
+#include "par_map_iterator.hpp"
+
+namespace millrind
+{
+namespace detail
+{
+template <class Func>
+struct flat_map_batch
+{
+    Func func;
+
+    template <class T>
+    auto operator()(T& item, const std::atomic<bool>& cancelled) const
+    {
+        auto&& inner = call(func, item);
+        std::vector<range_value_t<decltype(inner)>> result;
+        for (auto&& element : inner)
+        {
+            if (cancelled.load(std::memory_order_relaxed))
+                break;
+            result.push_back(std::forward<decltype(element)>(element));
+        }
+        return result;
+    }
+};
+
+}  // namespace detail
+
+template <class Iter, class Func, class Ordered, class Pool>
+class par_flat_map_iterator : public iterator_facade<par_flat_map_iterator<Iter, Func, Ordered, Pool>>
+{
+private:
+    using state_type = detail::par_map_state<Iter, detail::flat_map_batch<Func>, Ordered, Pool>;
+    using batch_type = typename state_type::value_type;
+    using value_type = typename batch_type::value_type;
+
+public:
+    par_flat_map_iterator() = default;
+
+    explicit par_flat_map_iterator(std::shared_ptr<state_type> state)
+        : _state{ std::move(state) }
+        , _batch{}
+        , _pos{ 0 }
+        , _index{ 0 }
+    {
+        next_batch();
+    }
+
+    par_flat_map_iterator(const par_flat_map_iterator&) = default;
+
+    value_type deref() const
+    {
+        return (*_batch)[_pos];
+    }
+
+    void inc()
+    {
+        ++_index;
+        if (++_pos == _batch->size())
+            next_batch();
+    }
+
+    bool is_equal(const par_flat_map_iterator& other) const
+    {
+        if (!_batch || !other._batch)
+            return !_batch && !other._batch;
+        return _state == other._state && _index == other._index;
+    }
+
+private:
+    void next_batch()
+    {
+        _batch.reset();
+        _pos = 0;
+        while (auto batch = _state->pop())
+        {
+            if (!batch->empty())
+            {
+                _batch = std::make_shared<const batch_type>(std::move(*batch));
+                return;
+            }
+        }
+    }
+
+    std::shared_ptr<state_type> _state;
+    std::shared_ptr<const batch_type> _batch;
+    std::size_t _pos = 0;
+    std::ptrdiff_t _index = 0;
+};
+
+}  // namespace millrind
+
+MILLRIND_INPUT_ITERATOR_TRAITS(::millrind::par_flat_map_iterator)
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../iterator_facade.hpp"
+#include "../pipeable.hpp"
+#include "../thread_pool.hpp"
+#include "../type_traits.hpp"
+
+namespace millrind
+{
+namespace detail
+{
+template <class Func, class T>
+decltype(auto) invoke_cancellable(const Func& func, T& item, const std::atomic<bool>& cancelled)
+{
+    if constexpr (std::is_invocable_v<const Func&, T&, const std::atomic<bool>&>)
+        return std::invoke(func, item, cancelled);
+    else
+        return call(func, item);
+}
+
+template <class Iter, class Func, class Ordered, class Pool>
+class par_map_state
+{
+private:
+    using input_type = iter_value_t<Iter>;
+
+public:
+    using value_type = std::decay_t<decltype(
+        invoke_cancellable(std::declval<const Func&>(), std::declval<input_type&>(), std::declval<const std::atomic<bool>&>()))>;
+
+    par_map_state(Iter begin, Iter end, Func func, std::shared_ptr<Pool> pool, std::size_t window)
+        : _it{ std::move(begin) }
+        , _end{ std::move(end) }
+        , _func{ std::move(func) }
+        , _window{ std::max<std::size_t>(window, 1) }
+        , _slots(Ordered::value ? _window : 0)
+        , _completed{}
+        , _head{ 0 }
+        , _tail{ 0 }
+        , _running{ 0 }
+        , _cancelled{ false }
+        , _pool{ std::move(pool) }
+    {
+    }
+
+    par_map_state(const par_map_state&) = delete;
+    par_map_state& operator=(const par_map_state&) = delete;
+
+    ~par_map_state()
+    {
+        _cancelled.store(true, std::memory_order_release);
+        std::unique_lock lock{ _mutex };
+        _ready.wait(lock, [this] { return _running == 0; });
+    }
+
+    std::optional<value_type> pop()
+    {
+        fill();
+        if (_head == _tail)
+            return std::nullopt;
+
+        result result;
+        {
+            std::unique_lock lock{ _mutex };
+            if constexpr (Ordered::value)
+            {
+                auto& slot = _slots[_head % _window];
+                _ready.wait(lock, [&] { return slot.has_value(); });
+                result = std::move(*slot);
+                slot.reset();
+            }
+            else
+            {
+                _ready.wait(lock, [&] { return !_completed.empty(); });
+                result = std::move(_completed.front());
+                _completed.pop_front();
+            }
+        }
+        ++_head;
+
+        if (result.error)
+            std::rethrow_exception(result.error);
+        fill();
+        return std::move(result.value);
+    }
+
+private:
+    struct result
+    {
+        std::optional<value_type> value;
+        std::exception_ptr error;
+    };
+
+    void fill()
+    {
+        while (_it != _end && _tail - _head < _window)
+        {
+            auto item = input_type(*_it);
+            {
+                std::lock_guard lock{ _mutex };
+                ++_running;
+            }
+            try
+            {
+                _pool->post([this, index = _tail, item = std::move(item)]() mutable { complete(index, item); });
+            }
+            catch (...)
+            {
+                std::lock_guard lock{ _mutex };
+                --_running;
+                throw;
+            }
+            ++_tail;
+            ++_it;
+        }
+    }
+
+    void complete(std::size_t index, input_type& item)
+    {
+        result result;
+        if (!_cancelled.load(std::memory_order_acquire))
+        {
+            try
+            {
+                result.value.emplace(invoke_cancellable(_func, item, _cancelled));
+            }
+            catch (...)
+            {
+                result.error = std::current_exception();
+            }
+        }
+
+        std::lock_guard lock{ _mutex };
+        if constexpr (Ordered::value)
+            _slots[index % _window] = std::move(result);
+        else
+            _completed.push_back(std::move(result));
+        --_running;
+        _ready.notify_all();
+    }
+
+    Iter _it;
+    Iter _end;
+    Func _func;
+    std::size_t _window;
+    std::vector<std::optional<result>> _slots;
+    std::deque<result> _completed;
+    std::size_t _head;
+    std::size_t _tail;
+    std::mutex _mutex;
+    std::condition_variable _ready;
+    std::size_t _running;
+    std::atomic<bool> _cancelled;
+    std::shared_ptr<Pool> _pool;
+};
+
+}  // namespace detail
+
+template <class Iter, class Func, class Ordered, class Pool>
+class par_map_iterator : public iterator_facade<par_map_iterator<Iter, Func, Ordered, Pool>>
+{
+private:
+    using state_type = detail::par_map_state<Iter, Func, Ordered, Pool>;
+    using value_type = typename state_type::value_type;
+
+public:
+    par_map_iterator() = default;
+
+    explicit par_map_iterator(std::shared_ptr<state_type> state)
+        : _state{ std::move(state) }
+        , _current{ _state->pop() }
+        , _index{ 0 }
+    {
+    }
+
+    par_map_iterator(const par_map_iterator&) = default;
+
+    value_type deref() const
+    {
+        return *_current;
+    }
+
+    void inc()
+    {
+        _current = _state->pop();
+        ++_index;
+    }
+
+    bool is_equal(const par_map_iterator& other) const
+    {
+        if (!_current || !other._current)
+            return !_current && !other._current;
+        return _state == other._state && _index == other._index;
+    }
+
+private:
+    std::shared_ptr<state_type> _state;
+    std::optional<value_type> _current;
+    std::ptrdiff_t _index = 0;
+};
+
+}  // namespace millrind
+
+MILLRIND_INPUT_ITERATOR_TRAITS(::millrind::par_map_iterator)
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../iterator_facade.hpp"
+#include "../parse.hpp"
+
+namespace millrind
+{
+template <class T>
+class parse_iterator : public iterator_facade<parse_iterator<T>>
+{
+public:
+    parse_iterator() = default;
+
+    parse_iterator(const char* begin, const char* pos, const char* end, char delimiter)
+        : _begin{ begin }
+        , _pos{ pos }
+        , _end{ end }
+        , _token_end{ pos }
+        , _delimiter{ delimiter }
+        , _value{}
+    {
+        parse();
+    }
+
+    parse_iterator(const parse_iterator&) = default;
+
+    const T& deref() const
+    {
+        return _value;
+    }
+
+    void inc()
+    {
+        _pos = _token_end != _end ? _token_end + 1 : _end;
+        parse();
+    }
+
+    bool is_equal(const parse_iterator& other) const
+    {
+        return _pos == other._pos;
+    }
+
+private:
+    void parse()
+    {
+        if (_pos == _end)
+            return;
+
+        _token_end = detail::find_byte(_pos, _end, _delimiter);
+        if (!detail::parse_token(_pos, _token_end, _value))
+            throw parse_error{ std::string_view(_pos, _token_end - _pos), std::size_t(_pos - _begin) };
+    }
+
+    const char* _begin;
+    const char* _pos;
+    const char* _end;
+    const char* _token_end;
+    char _delimiter;
+    T _value;
+};
+
+}  // namespace millrind
+
+MILLRIND_ITERATOR_TRAITS(::millrind::parse_iterator)
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "../iterator_facade.hpp"
+
+namespace millrind
+{
+struct probe_stats
+{
+    std::string name;
+    std::atomic<std::size_t> elements{ 0 };
+    std::atomic<std::int64_t> nanoseconds{ 0 };
+    const probe_stats* upstream = nullptr;
+
+    explicit probe_stats(std::string name)
+        : name{ std::move(name) }
+    {
+    }
+};
+
+namespace detail
+{
+class probe_timer
+{
+public:
+    explicit probe_timer(probe_stats& stats)
+        : _stats{ stats }
+        , _start{ std::chrono::steady_clock::now() }
+    {
+    }
+
+    ~probe_timer()
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - _start;
+        _stats.nanoseconds.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), std::memory_order_relaxed);
+    }
+
+private:
+    probe_stats& _stats;
+    std::chrono::steady_clock::time_point _start;
+};
+
+}  // namespace detail
+
+template <class Iter>
+class probe_iterator : public iterator_facade<probe_iterator<Iter>>
+{
+public:
+    probe_iterator() = default;
+
+    probe_iterator(Iter iter, probe_stats* stats)
+        : _iter{ std::move(iter) }
+        , _stats{ stats }
+    {
+    }
+
+    probe_iterator(const probe_iterator&) = default;
+
+    decltype(auto) deref() const
+    {
+        const detail::probe_timer timer{ *_stats };
+        return *_iter;
+    }
+
+    void inc()
+    {
+        const detail::probe_timer timer{ *_stats };
+        ++_iter;
+        _stats->elements.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template <class It = Iter, class = bidirectional_iterator<It>>
+    void dec()
+    {
+        const detail::probe_timer timer{ *_stats };
+        --_iter;
+    }
+
+    bool is_equal(const probe_iterator& other) const
+    {
+        return _iter == other._iter;
+    }
+
+    template <class It = Iter, class = random_access_iterator<It>>
+    bool is_less(const probe_iterator& other) const
+    {
+        return _iter < other._iter;
+    }
+
+    template <class It = Iter, class = random_access_iterator<It>>
+    void advance(std::ptrdiff_t offset)
+    {
+        const detail::probe_timer timer{ *_stats };
+        _iter += offset;
+        if (offset > 0)
+            _stats->elements.fetch_add(std::size_t(offset), std::memory_order_relaxed);
+    }
+
+    template <class It = Iter, class = random_access_iterator<It>>
+    auto distance_to(const probe_iterator& other) const
+    {
+        return other._iter - _iter;
+    }
+
+private:
+    Iter _iter;
+    probe_stats* _stats;
+};
+
+}  // namespace millrind
+
+MILLRIND_ITERATOR_TRAITS(::millrind::probe_iterator)
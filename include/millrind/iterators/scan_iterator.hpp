@@ -0,0 +1,53 @@
+#pragma once
+
+#include <optional>
+
+#include "../iterator_facade.hpp"
+#include "default_constructible_func.hpp"
+
+namespace millrind
+{
+template <class Func, class T, class Iter>
+class scan_iterator : public iterator_facade<scan_iterator<Func, T, Iter>>
+{
+public:
+    scan_iterator() = default;
+
+    scan_iterator(Func func, T init, Iter iter, Iter end)
+        : _func{ std::move(func) }
+        , _iter{ std::move(iter) }
+        , _end{ std::move(end) }
+        , _current{}
+    {
+        if (_iter != _end)
+            _current = call(_func, std::move(init), *_iter);
+    }
+
+    scan_iterator(const scan_iterator&) = default;
+
+    const T& deref() const
+    {
+        return *_current;
+    }
+
+    void inc()
+    {
+        if (++_iter != _end)
+            _current = call(_func, *std::move(_current), *_iter);
+    }
+
+    bool is_equal(const scan_iterator& other) const
+    {
+        return _iter == other._iter;
+    }
+
+private:
+    default_constructible_func<Func> _func;
+    Iter _iter;
+    Iter _end;
+    std::optional<T> _current;
+};
+
+}  // namespace millrind
+
+MILLRIND_ITERATOR_TRAITS(::millrind::scan_iterator)
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "../algorithm.hpp"
+#include "../iterator_facade.hpp"
+#include "default_constructible_func.hpp"
+
+namespace millrind
+{
+struct set_union_tag
+{
+};
+
+struct set_intersection_tag
+{
+};
+
+struct set_difference_tag
+{
+};
+
+struct set_symmetric_difference_tag
+{
+};
+
+template <class Tag, class Compare, class Proj1, class Proj2, class Iter1, class Iter2>
+class set_operation_iterator : public iterator_facade<set_operation_iterator<Tag, Compare, Proj1, Proj2, Iter1, Iter2>>
+{
+private:
+    static constexpr bool is_union = std::is_same_v<Tag, set_union_tag>;
+    static constexpr bool is_intersection = std::is_same_v<Tag, set_intersection_tag>;
+    static constexpr bool is_difference = std::is_same_v<Tag, set_difference_tag>;
+    static constexpr bool is_symmetric_difference = std::is_same_v<Tag, set_symmetric_difference_tag>;
+
+    static constexpr bool can_gallop = is_detected_v<random_access_iterator, Iter1> && is_detected_v<random_access_iterator, Iter2>;
+    static constexpr std::ptrdiff_t gallop_ratio = 8;
+
+    using reference = std::conditional_t<
+        std::is_same_v<iter_reference_t<Iter1>, iter_reference_t<Iter2>>,
+        iter_reference_t<Iter1>,
+        std::common_type_t<iter_value_t<Iter1>, iter_value_t<Iter2>>>;
+
+    enum source : char
+    {
+        none,
+        first,
+        second,
+        both
+    };
+
+public:
+    set_operation_iterator() = default;
+
+    set_operation_iterator(Compare compare, Proj1 proj1, Proj2 proj2, Iter1 iter1, Iter1 end1, Iter2 iter2, Iter2 end2)
+        : _compare{ std::move(compare) }
+        , _proj1{ std::move(proj1) }
+        , _proj2{ std::move(proj2) }
+        , _iter1{ std::move(iter1) }
+        , _end1{ std::move(end1) }
+        , _iter2{ std::move(iter2) }
+        , _end2{ std::move(end2) }
+        , _source{ none }
+        , _gallop{ false }
+    {
+        if constexpr (can_gallop)
+        {
+            const auto size1 = std::distance(_iter1, _end1);
+            const auto size2 = std::distance(_iter2, _end2);
+            _gallop = std::max(size1, size2) >= gallop_ratio * std::min(size1, size2);
+        }
+        settle();
+    }
+
+    set_operation_iterator(const set_operation_iterator&) = default;
+
+    reference deref() const
+    {
+        if (_source == second)
+            return *_iter2;
+        else
+            return *_iter1;
+    }
+
+    void inc()
+    {
+        if (_source != second)
+            ++_iter1;
+        if (_source != first)
+            ++_iter2;
+        settle();
+    }
+
+    bool is_equal(const set_operation_iterator& other) const
+    {
+        return _iter1 == other._iter1 && _iter2 == other._iter2;
+    }
+
+private:
+    bool less12() const
+    {
+        return call(_compare, call(_proj1, *_iter1), call(_proj2, *_iter2));
+    }
+
+    bool less21() const
+    {
+        return call(_compare, call(_proj2, *_iter2), call(_proj1, *_iter1));
+    }
+
+    template <class Iter, class Proj, class T>
+    Iter skip(Iter it, Iter end, const Proj& proj, const T& value) const
+    {
+        if constexpr (can_gallop)
+        {
+            if (_gallop)
+            {
+                auto lo = it;
+                auto hi = end;
+                for (std::ptrdiff_t step = 1; step < end - lo; step *= 2)
+                {
+                    if (!call(_compare, call(proj, lo[step]), value))
+                    {
+                        hi = lo + step;
+                        break;
+                    }
+                    lo += step;
+                }
+                return ::millrind::detail::lower_bound(lo, hi, value, ref(_compare), ref(proj));
+            }
+        }
+
+        while (it != end && call(_compare, call(proj, *it), value))
+        {
+            ++it;
+        }
+        return it;
+    }
+
+    void finish()
+    {
+        _iter1 = _end1;
+        _iter2 = _end2;
+        _source = none;
+    }
+
+    void settle()
+    {
+        while (true)
+        {
+            if (_iter1 == _end1)
+            {
+                if ((is_union || is_symmetric_difference) && _iter2 != _end2)
+                    _source = second;
+                else
+                    finish();
+                return;
+            }
+
+            if (_iter2 == _end2)
+            {
+                if (!is_intersection)
+                    _source = first;
+                else
+                    finish();
+                return;
+            }
+
+            if (less12())
+            {
+                if constexpr (is_intersection)
+                {
+                    _iter1 = skip(_iter1, _end1, _proj1, call(_proj2, *_iter2));
+                    continue;
+                }
+                _source = first;
+                return;
+            }
+
+            if (less21())
+            {
+                if constexpr (is_union || is_symmetric_difference)
+                {
+                    _source = second;
+                    return;
+                }
+                _iter2 = skip(_iter2, _end2, _proj2, call(_proj1, *_iter1));
+                continue;
+            }
+
+            if constexpr (is_union || is_intersection)
+            {
+                _source = both;
+                return;
+            }
+            ++_iter1;
+            ++_iter2;
+        }
+    }
+
+    default_constructible_func<Compare> _compare;
+    default_constructible_func<Proj1> _proj1;
+    default_constructible_func<Proj2> _proj2;
+    Iter1 _iter1;
+    Iter1 _end1;
+    Iter2 _iter2;
+    Iter2 _end2;
+    source _source;
+    bool _gallop;
+};
+
+}  // namespace millrind
+
+MILLRIND_ITERATOR_TRAITS(::millrind::set_operation_iterator)
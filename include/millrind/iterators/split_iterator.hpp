@@ -0,0 +1,120 @@
+#pragma once
+
+#include <string_view>
+#include <utility>
+
+#include "../iterator_facade.hpp"
+#include "../simd.hpp"
+
+namespace millrind
+{
+namespace detail
+{
+struct byte_delimiter
+{
+    char delimiter;
+
+    std::pair<const char*, const char*> operator()(const char* b, const char* e) const
+    {
+        const auto found = find_byte(b, e, delimiter);
+        return { found, found != e ? found + 1 : e };
+    }
+};
+
+struct substring_delimiter
+{
+    std::string_view delimiter;
+
+    std::pair<const char*, const char*> operator()(const char* b, const char* e) const
+    {
+        if (delimiter.empty())
+            return { e, e };
+        const auto found = find_substring(b, e, delimiter.data(), delimiter.size());
+        return { found, found != e ? found + delimiter.size() : e };
+    }
+};
+
+struct any_byte_delimiter
+{
+    std::string_view delimiters;
+
+    std::pair<const char*, const char*> operator()(const char* b, const char* e) const
+    {
+        const auto found = find_any_byte(b, e, delimiters);
+        return { found, found != e ? found + 1 : e };
+    }
+};
+
+struct line_delimiter
+{
+    std::pair<const char*, const char*> operator()(const char* b, const char* e) const
+    {
+        const auto found = find_byte(b, e, '\n');
+        const auto token_end = found != b && found[-1] == '\r' ? found - 1 : found;
+        return { token_end, found != e ? found + 1 : e };
+    }
+};
+
+}  // namespace detail
+
+template <class Delimiter>
+class split_iterator : public iterator_facade<split_iterator<Delimiter>>
+{
+public:
+    split_iterator() = default;
+
+    split_iterator(Delimiter delimiter, const char* pos, const char* end, bool keep_trailing)
+        : _delimiter{ std::move(delimiter) }
+        , _pos{ pos }
+        , _end{ end }
+        , _token_end{ pos }
+        , _next{ pos }
+        , _keep_trailing{ keep_trailing }
+        , _done{ pos == end }
+    {
+        if (!_done)
+            find();
+    }
+
+    split_iterator(const split_iterator&) = default;
+
+    std::string_view deref() const
+    {
+        return { _pos, std::size_t(_token_end - _pos) };
+    }
+
+    void inc()
+    {
+        if (_token_end == _end || (_next == _end && !_keep_trailing))
+        {
+            _pos = _end;
+            _done = true;
+            return;
+        }
+        _pos = _next;
+        find();
+    }
+
+    bool is_equal(const split_iterator& other) const
+    {
+        return _done == other._done && (_done || _pos == other._pos);
+    }
+
+private:
+    void find()
+    {
+        std::tie(_token_end, _next) = _delimiter(_pos, _end);
+    }
+
+    Delimiter _delimiter;
+    const char* _pos;
+    const char* _end;
+    const char* _token_end;
+    const char* _next;
+    bool _keep_trailing;
+    bool _done;
+};
+
+}  // namespace millrind
+
+MILLRIND_ITERATOR_TRAITS(::millrind::split_iterator)
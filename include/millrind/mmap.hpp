@@ -0,0 +1,172 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "iterator_range.hpp"
+#include "iterators/owning_iterator.hpp"
+#include "iterators/split_iterator.hpp"
+
+namespace millrind
+{
+struct mmap_options
+{
+    bool sequential = true;
+    bool populate = false;
+};
+
+class mapped_file
+{
+public:
+    explicit mapped_file(const std::string& path, mmap_options options = {})
+        : _data{ nullptr }
+        , _size{ 0 }
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw_error("cannot open '" + path + "'");
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0)
+        {
+            const auto error = errno;
+            ::close(fd);
+            throw_error("cannot stat '" + path + "'", error);
+        }
+
+        _size = static_cast<std::size_t>(info.st_size);
+        if (_size > 0)
+        {
+            int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+            if (options.populate)
+                flags |= MAP_POPULATE;
+#endif
+            void* addr = ::mmap(nullptr, _size, PROT_READ, flags, fd, 0);
+            if (addr == MAP_FAILED)
+            {
+                const auto error = errno;
+                ::close(fd);
+                throw_error("cannot map '" + path + "'", error);
+            }
+            _data = static_cast<const char*>(addr);
+
+            if (options.sequential)
+                ::madvise(addr, _size, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    mapped_file(mapped_file&& other) noexcept
+        : _data{ std::exchange(other._data, nullptr) }
+        , _size{ std::exchange(other._size, 0) }
+    {
+    }
+
+    mapped_file& operator=(mapped_file&& other) noexcept
+    {
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+        return *this;
+    }
+
+    ~mapped_file()
+    {
+        if (_data)
+            ::munmap(const_cast<char*>(_data), _size);
+    }
+
+    const char* data() const
+    {
+        return _data;
+    }
+
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    const char* begin() const
+    {
+        return _data;
+    }
+
+    const char* end() const
+    {
+        return _data + _size;
+    }
+
+    std::string_view view() const
+    {
+        return { _data, _size };
+    }
+
+private:
+    [[noreturn]] static void throw_error(const std::string& message, int error = errno)
+    {
+        throw std::system_error{ error, std::generic_category(), message };
+    }
+
+    const char* _data;
+    std::size_t _size;
+};
+
+namespace detail
+{
+struct mmap_range_fn
+{
+    auto operator()(const std::string& path, mmap_options options = {}) const
+    {
+        using result_type = owning_iterator<const char*, mapped_file>;
+
+        const auto file = std::make_shared<mapped_file>(path, options);
+        return make_range(result_type{ file->begin(), file }, result_type{ file->end(), file });
+    }
+};
+
+}  // namespace detail
+
+static constexpr inline auto mmap_range = detail::mmap_range_fn{};
+
+namespace seq
+{
+namespace detail
+{
+struct mapped_lines_fn
+{
+    auto operator()(const std::string& path, mmap_options options = {}) const
+    {
+        using split_type = split_iterator<::millrind::detail::line_delimiter>;
+        using result_type = owning_iterator<split_type, mapped_file>;
+
+        const auto file = std::make_shared<mapped_file>(path, options);
+        return make_range(
+            result_type{ split_type{ {}, file->begin(), file->end(), false }, file },
+            result_type{ split_type{ {}, file->end(), file->end(), false }, file });
+    }
+};
+
+}  // namespace detail
+
+static constexpr inline auto mapped_lines = detail::mapped_lines_fn{};
+
+}  // namespace seq
+
+}  // namespace millrind
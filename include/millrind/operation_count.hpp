@@ -0,0 +1,289 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "pipeable.hpp"
+
+namespace millrind
+{
+struct operation_counts
+{
+    std::size_t comparisons = 0;
+    std::size_t projections = 0;
+    std::size_t moves = 0;
+    std::size_t copies = 0;
+};
+
+struct operation_site
+{
+    std::string name;
+    std::atomic<std::size_t> comparisons{ 0 };
+    std::atomic<std::size_t> projections{ 0 };
+    std::atomic<std::size_t> moves{ 0 };
+    std::atomic<std::size_t> copies{ 0 };
+
+    explicit operation_site(std::string name)
+        : name{ std::move(name) }
+    {
+    }
+
+    operation_counts counts() const
+    {
+        return { comparisons.load(std::memory_order_relaxed),
+                 projections.load(std::memory_order_relaxed),
+                 moves.load(std::memory_order_relaxed),
+                 copies.load(std::memory_order_relaxed) };
+    }
+};
+
+class operation_registry
+{
+public:
+    static operation_registry& instance()
+    {
+        static operation_registry result;
+        return result;
+    }
+
+    operation_site& get(std::string_view name)
+    {
+        std::lock_guard lock{ _mutex };
+        for (auto& site : _sites)
+        {
+            if (site.name == name)
+                return site;
+        }
+        return _sites.emplace_back(std::string{ name });
+    }
+
+    operation_counts counts(std::string_view name) const
+    {
+        std::lock_guard lock{ _mutex };
+        for (const auto& site : _sites)
+        {
+            if (site.name == name)
+                return site.counts();
+        }
+        return {};
+    }
+
+    std::vector<std::pair<std::string, operation_counts>> snapshot() const
+    {
+        std::lock_guard lock{ _mutex };
+        std::vector<std::pair<std::string, operation_counts>> result;
+        result.reserve(_sites.size());
+        for (const auto& site : _sites)
+        {
+            result.emplace_back(site.name, site.counts());
+        }
+        return result;
+    }
+
+    void reset()
+    {
+        std::lock_guard lock{ _mutex };
+        for (auto& site : _sites)
+        {
+            site.comparisons.store(0, std::memory_order_relaxed);
+            site.projections.store(0, std::memory_order_relaxed);
+            site.moves.store(0, std::memory_order_relaxed);
+            site.copies.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    operation_registry() = default;
+
+    mutable std::mutex _mutex;
+    std::deque<operation_site> _sites;
+};
+
+namespace detail
+{
+inline operation_site*& current_operation_site()
+{
+    thread_local operation_site* site = nullptr;
+    return site;
+}
+
+inline std::string& current_operation_label()
+{
+    thread_local std::string label;
+    return label;
+}
+
+class operation_site_guard
+{
+public:
+    explicit operation_site_guard(std::string_view name)
+        : _active{ current_operation_site() == nullptr }
+    {
+        if (!_active)
+            return;
+        const auto& label = current_operation_label();
+        current_operation_site() = label.empty()
+            ? &operation_registry::instance().get(name)
+            : &operation_registry::instance().get(label + ":" + std::string{ name });
+    }
+
+    operation_site_guard(const operation_site_guard&) = delete;
+    operation_site_guard& operator=(const operation_site_guard&) = delete;
+
+    ~operation_site_guard()
+    {
+        if (_active)
+            current_operation_site() = nullptr;
+    }
+
+private:
+    bool _active;
+};
+
+template <std::atomic<std::size_t> operation_site::*Counter>
+inline void count_operation(std::size_t n = 1)
+{
+    if (auto site = current_operation_site())
+        (site->*Counter).fetch_add(n, std::memory_order_relaxed);
+}
+
+template <class Proj>
+constexpr bool is_counted_projection_v = !std::is_same_v<std::decay_t<decltype(unwrap(std::declval<Proj>()))>, identity>;
+
+inline void count_comparison()
+{
+    count_operation<&operation_site::comparisons>();
+}
+
+template <class Proj>
+inline void count_projection()
+{
+    if constexpr (is_counted_projection_v<Proj>)
+        count_operation<&operation_site::projections>();
+}
+
+template <class Proj>
+struct counting_projection
+{
+    Proj proj;
+
+    template <class T>
+    decltype(auto) operator()(T&& item) const
+    {
+        count_projection<Proj>();
+        return call(proj, std::forward<T>(item));
+    }
+};
+
+template <class Proj>
+constexpr auto count_projections(Proj proj)
+{
+#ifdef MILLRIND_COUNT_OPERATIONS
+    if constexpr (is_counted_projection_v<Proj>)
+        return counting_projection<Proj>{ std::move(proj) };
+    else
+        return proj;
+#else
+    return proj;
+#endif
+}
+
+}  // namespace detail
+
+class operation_count_scope
+{
+public:
+    explicit operation_count_scope(std::string label)
+        : _previous{ std::exchange(detail::current_operation_label(), std::move(label)) }
+    {
+    }
+
+    operation_count_scope(const operation_count_scope&) = delete;
+    operation_count_scope& operator=(const operation_count_scope&) = delete;
+
+    ~operation_count_scope()
+    {
+        detail::current_operation_label() = std::move(_previous);
+    }
+
+private:
+    std::string _previous;
+};
+
+template <class T>
+struct counted
+{
+    T value;
+
+    counted() = default;
+
+    counted(T value)
+        : value{ std::move(value) }
+    {
+    }
+
+    counted(const counted& other)
+        : value{ other.value }
+    {
+        detail::count_operation<&operation_site::copies>();
+    }
+
+    counted(counted&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : value{ std::move(other.value) }
+    {
+        detail::count_operation<&operation_site::moves>();
+    }
+
+    counted& operator=(const counted& other)
+    {
+        value = other.value;
+        detail::count_operation<&operation_site::copies>();
+        return *this;
+    }
+
+    counted& operator=(counted&& other) noexcept(std::is_nothrow_move_assignable_v<T>)
+    {
+        value = std::move(other.value);
+        detail::count_operation<&operation_site::moves>();
+        return *this;
+    }
+
+    friend bool operator==(const counted& lhs, const counted& rhs)
+    {
+        return lhs.value == rhs.value;
+    }
+
+    friend bool operator!=(const counted& lhs, const counted& rhs)
+    {
+        return lhs.value != rhs.value;
+    }
+
+    friend bool operator<(const counted& lhs, const counted& rhs)
+    {
+        return lhs.value < rhs.value;
+    }
+
+    friend bool operator>(const counted& lhs, const counted& rhs)
+    {
+        return lhs.value > rhs.value;
+    }
+
+    friend bool operator<=(const counted& lhs, const counted& rhs)
+    {
+        return lhs.value <= rhs.value;
+    }
+
+    friend bool operator>=(const counted& lhs, const counted& rhs)
+    {
+        return lhs.value >= rhs.value;
+    }
+};
+
+}  // namespace millrind
@@ -5,6 +5,10 @@
 #include <sstream>
 #include <string_view>
 
+#include "format.hpp"
+#include "pipeable.hpp"
+#include "type_traits.hpp"
+
 namespace millrind
 {
 struct ostream_manipulator
@@ -54,28 +58,34 @@ struct ostream_iterator : std::iterator<std::output_iterator_tag, void, void, vo
     }
 };
 
+template <class Iter, class Proj>
+struct delimited
+{
+    Iter begin;
+    Iter end;
+    std::string_view separator;
+    Proj proj;
+
+    friend std::ostream& operator<<(std::ostream& os, const delimited& item)
+    {
+        for (auto it = item.begin; it != item.end; ++it)
+        {
+            if (it != item.begin)
+                os << item.separator;
+            os << std::invoke(item.proj, *it);
+        }
+        return os;
+    }
+};
+
 namespace detail
 {
 struct delimit_fn
 {
     template <class Range, class Proj = identity>
-    auto operator()(Range&& range, std::string_view separator = {}, Proj proj = {}) const -> ostream_manipulator
-    {
-        return impl(std::begin(range), std::end(range), separator, proj);
-    }
-
-private:
-    template <class Iter, class Proj = identity>
-    auto impl(Iter begin, Iter end, std::string_view separator = {}, Proj proj = {}) const -> ostream_manipulator
+    auto operator()(Range&& range, std::string_view separator = {}, Proj proj = {}) const
     {
-        return { [=](std::ostream& os) {
-            for (auto it = begin; it != end; ++it)
-            {
-                if (it != begin)
-                    os << separator;
-                os << std::invoke(proj, *it);
-            }
-        } };
+        return delimited<iterator_t<Range>, Proj>{ std::begin(range), std::end(range), separator, std::move(proj) };
     }
 };
 
@@ -94,9 +104,16 @@ struct str_fn
     template <class... Args>
     std::string operator()(Args&&... args) const
     {
-        std::stringstream ss;
-        write_fn{}(ss, std::forward<Args>(args)...);
-        return ss.str();
+        if constexpr ((is_directly_formatted_v<std::decay_t<Args>> && ...))
+        {
+            return str_cat(args...);
+        }
+        else
+        {
+            std::stringstream ss;
+            write_fn{}(ss, std::forward<Args>(args)...);
+            return ss.str();
+        }
     }
 };
 
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "iterator_range.hpp"
+#include "iterators/par_flat_map_iterator.hpp"
+#include "iterators/par_map_iterator.hpp"
+#include "pipeable.hpp"
+#include "thread_pool.hpp"
+
+namespace millrind
+{
+namespace seq
+{
+namespace detail
+{
+template <class Pool>
+std::shared_ptr<Pool> borrow_pool(Pool& pool)
+{
+    return std::shared_ptr<Pool>{ std::shared_ptr<Pool>{}, &pool };
+}
+
+template <class Ordered>
+struct par_map_fn
+{
+    template <class Range, class Func>
+    auto operator()(Range&& range, Func func, std::size_t workers = 0, std::size_t window = 0) const
+    {
+        using state_type = ::millrind::detail::par_map_state<iterator_t<Range>, Func, Ordered, thread_pool>;
+        using result_type = par_map_iterator<iterator_t<Range>, Func, Ordered, thread_pool>;
+
+        if (workers == 0)
+            workers = ::millrind::detail::hardware_concurrency();
+        if (window == 0)
+            window = 4 * workers;
+
+        auto state = std::make_shared<state_type>(
+            std::begin(range), std::end(range), std::move(func), std::make_shared<thread_pool>(workers), window);
+        return make_range(result_type{ std::move(state) }, result_type{});
+    }
+};
+
+template <class Ordered>
+struct par_flat_map_fn
+{
+    template <class Range, class Func, class Pool>
+    auto operator()(Range&& range, Func func, Pool& pool, std::size_t window = 0) const
+    {
+        using batch_type = ::millrind::detail::flat_map_batch<Func>;
+        using state_type = ::millrind::detail::par_map_state<iterator_t<Range>, batch_type, Ordered, Pool>;
+        using result_type = par_flat_map_iterator<iterator_t<Range>, Func, Ordered, Pool>;
+
+        if (window == 0)
+            window = 4 * pool.size();
+
+        auto state = std::make_shared<state_type>(
+            std::begin(range), std::end(range), batch_type{ std::move(func) }, borrow_pool(pool), window);
+        return make_range(result_type{ std::move(state) }, result_type{});
+    }
+};
+
+struct par_for_each_fn
+{
+    template <class Range, class Func, class Pool>
+    void operator()(Range&& range, Func func, Pool& pool, std::size_t window = 0) const
+    {
+        auto apply = [func = std::move(func)](auto& item)
+        {
+            call(func, item);
+            return true;
+        };
+        using state_type = ::millrind::detail::par_map_state<iterator_t<Range>, decltype(apply), std::false_type, Pool>;
+
+        if (window == 0)
+            window = 4 * pool.size();
+
+        state_type state{ std::begin(range), std::end(range), std::move(apply), borrow_pool(pool), window };
+        while (state.pop())
+        {
+        }
+    }
+};
+
+struct par_collect_fn
+{
+    template <class Range, class Func, class Pool>
+    auto operator()(Range&& range, Func func, Pool& pool, std::size_t window = 0) const
+    {
+        auto items = par_flat_map_fn<std::true_type>{}(std::forward<Range>(range), std::move(func), pool, window);
+        std::vector<range_value_t<decltype(items)>> result;
+        for (auto&& item : items)
+        {
+            result.push_back(item);
+        }
+        return result;
+    }
+};
+
+template <class Func>
+struct with_pool_fn
+{
+    template <class F, class Pool>
+    auto operator()(F func, Pool& pool, std::size_t window = 0) const
+    {
+        return pipeable{ Func{} }(std::move(func), std::ref(pool), window);
+    }
+};
+
+}  // namespace detail
+
+static constexpr inline auto par_map = pipeable{ detail::par_map_fn<std::true_type>{} };
+static constexpr inline auto par_map_unordered = pipeable{ detail::par_map_fn<std::false_type>{} };
+
+static constexpr inline auto par_flat_map = detail::with_pool_fn<detail::par_flat_map_fn<std::true_type>>{};
+static constexpr inline auto par_flat_map_unordered = detail::with_pool_fn<detail::par_flat_map_fn<std::false_type>>{};
+static constexpr inline auto par_for_each = detail::with_pool_fn<detail::par_for_each_fn>{};
+static constexpr inline auto par_collect = detail::with_pool_fn<detail::par_collect_fn>{};
+
+}  // namespace seq
+
+}  // namespace millrind
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <future>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "algorithm.hpp"
+#include "iterator_range.hpp"
+#include "wrappers.hpp"
+
+namespace millrind
+{
+namespace detail
+{
+inline std::size_t hardware_concurrency()
+{
+    return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+template <class Iter>
+auto split_evenly(Iter b, Iter e, std::size_t parts) -> std::vector<iterator_range<Iter>>
+{
+    const auto size = std::distance(b, e);
+    const auto count = std::max<std::ptrdiff_t>(1, std::min<std::ptrdiff_t>(parts, size));
+
+    std::vector<iterator_range<Iter>> result;
+    result.reserve(count);
+    for (std::ptrdiff_t i = 0; i < count; ++i)
+    {
+        auto next = std::next(b, size / count + (i < size % count ? 1 : 0));
+        result.emplace_back(b, next);
+        b = next;
+    }
+    return result;
+}
+
+template <class Range, class Func>
+auto parallel_transform(Range&& partitions, Func func)
+{
+    using result_type = std::decay_t<decltype(std::invoke(func, unwrap(wrap(*std::begin(partitions)))))>;
+
+    std::vector<std::future<result_type>> futures;
+    for (auto&& partition : partitions)
+    {
+        futures.push_back(std::async(
+            std::launch::async,
+            [&func](auto p) { return std::invoke(func, unwrap(p)); },
+            wrap(std::forward<decltype(partition)>(partition))));
+    }
+
+    if constexpr (std::is_void_v<result_type>)
+    {
+        for (auto& future : futures)
+        {
+            future.get();
+        }
+    }
+    else
+    {
+        std::vector<result_type> result;
+        result.reserve(futures.size());
+        for (auto& future : futures)
+        {
+            result.push_back(future.get());
+        }
+        return result;
+    }
+}
+
+template <class Iter>
+auto split_for_parallel(Iter b, Iter e, std::ptrdiff_t min_chunk = 16384) -> std::vector<iterator_range<Iter>>
+{
+    const auto chunks = static_cast<std::size_t>(std::distance(b, e) / min_chunk);
+    return split_evenly(b, e, std::min(hardware_concurrency(), std::max<std::size_t>(1, chunks)));
+}
+
+template <class Iter, class Output, class T, class BinaryFunc, class Proj>
+Output par_scan(Iter b, Iter e, Output output, std::optional<T> init, bool inclusive, BinaryFunc func, Proj proj)
+{
+    const auto parts = split_for_parallel(b, e);
+
+    const auto sums = parallel_transform(make_range(std::begin(parts), std::prev(std::end(parts))), [&](const auto& part) {
+        std::optional<T> sum;
+        for (auto&& item : part)
+        {
+            sum = sum ? call(func, *std::move(sum), call(proj, item)) : T(call(proj, item));
+        }
+        return sum;
+    });
+
+    std::vector<std::pair<iterator_range<Iter>, std::optional<T>>> tasks;
+    tasks.reserve(parts.size());
+    for (std::size_t i = 0; i < parts.size(); ++i)
+    {
+        tasks.emplace_back(parts[i], init);
+        if (i < sums.size() && sums[i])
+            init = init ? call(func, *std::move(init), *sums[i]) : *sums[i];
+    }
+
+    parallel_transform(tasks, [&](const auto& task) {
+        auto out = std::next(output, std::distance(b, std::begin(task.first)));
+        auto acc = task.second;
+        for (auto&& item : task.first)
+        {
+            if (inclusive)
+            {
+                acc = acc ? call(func, *std::move(acc), call(proj, item)) : T(call(proj, item));
+                yield(out, *acc);
+            }
+            else
+            {
+                yield(out, *acc);
+                acc = call(func, *std::move(acc), call(proj, item));
+            }
+        }
+    });
+
+    return std::next(output, std::distance(b, e));
+}
+
+}  // namespace detail
+
+template <class Range, class Output, class BinaryFunc = std::plus<>, class Proj = identity>
+auto par_inclusive_scan(Range&& range, Output output, BinaryFunc func = {}, Proj proj = {})
+{
+    MILLRIND_CHECK_CONSTRAINT("par_inclusive_scan", range, random_access_range);
+    MILLRIND_CHECK_CONSTRAINT("par_inclusive_scan", output, random_access_iterator);
+
+    using value_type = std::decay_t<decltype(call(proj, *std::begin(range)))>;
+    return detail::par_scan(
+        std::begin(range), std::end(range), output, std::optional<value_type>{}, true, ref(func), ref(proj));
+}
+
+template <class Range, class Output, class T, class BinaryFunc = std::plus<>, class Proj = identity>
+auto par_exclusive_scan(Range&& range, Output output, T init, BinaryFunc func = {}, Proj proj = {})
+{
+    MILLRIND_CHECK_CONSTRAINT("par_exclusive_scan", range, random_access_range);
+    MILLRIND_CHECK_CONSTRAINT("par_exclusive_scan", output, random_access_iterator);
+
+    return detail::par_scan(
+        std::begin(range), std::end(range), output, std::optional<T>{ std::move(init) }, false, ref(func), ref(proj));
+}
+
+}  // namespace millrind
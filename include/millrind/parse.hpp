@@ -1,24 +1,91 @@
 #pragma once
 
+#include <charconv>
+#include <cstdint>
+#include <limits>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 #include <string_view>
+#include <system_error>
+#include <type_traits>
 
+#include "simd.hpp"
+#include "type_traits.hpp"
 #include "wrappers.hpp"
 
 namespace millrind
 {
+struct parse_error : std::runtime_error
+{
+    parse_error(std::string_view txt, std::size_t position)
+        : std::runtime_error{ "Cannot parse '" + std::string{ txt } + "' at position " + std::to_string(position) }
+        , position{ position }
+    {
+    }
+
+    std::size_t position;
+};
+
+template <class Out>
+struct parse_all_result
+{
+    Out out;
+    std::size_t count;
+    std::optional<std::size_t> error;
+};
+
 namespace detail
 {
+template <class T>
+static constexpr inline bool is_from_chars_parsable = std::is_floating_point_v<T>
+                                                      || (std::is_integral_v<T>
+                                                          && !std::is_same_v<T, bool>
+                                                          && !std::is_same_v<T, char>
+                                                          && !std::is_same_v<T, signed char>
+                                                          && !std::is_same_v<T, unsigned char>
+                                                          && !std::is_same_v<T, wchar_t>
+                                                          && !std::is_same_v<T, char16_t>
+                                                          && !std::is_same_v<T, char32_t>);
+
+template <class T>
+struct parse_errc_fn
+{
+    [[nodiscard]] std::errc operator()(std::string_view txt, ref<T> value) const
+    {
+        if constexpr (is_from_chars_parsable<T>)
+        {
+            auto b = txt.data();
+            const auto e = b + txt.size();
+            if (b != e && *b == '+' && (e - b == 1 || b[1] != '-'))
+                ++b;
+
+            T temp{};
+            const auto [ptr, ec] = std::from_chars(b, e, temp);
+            if (ec != std::errc{})
+                return ec;
+            if (ptr != e)
+                return std::errc::invalid_argument;
+
+            value.get() = temp;
+            return std::errc{};
+        }
+        else
+        {
+            std::stringstream ss{ std::string{ txt } };
+            ss >> value.get();
+            return !ss.fail() ? std::errc{} : std::errc::invalid_argument;
+        }
+    }
+};
+
 template <class T>
 struct try_parse_fn
 {
     [[nodiscard]] bool operator()(std::string_view txt, ref<T> value) const
     {
-        std::stringstream ss{ std::string{ txt } };
-        ss >> value.get();
-        return !ss.fail();
+        return parse_errc_fn<T>{}(txt, value) == std::errc{};
     }
 
     std::optional<T> operator()(std::string_view txt) const
@@ -36,25 +103,132 @@ struct parse_fn
 {
     T operator()(std::string_view txt) const
     {
-        if (auto maybe_value = try_parse_fn<T>{}(txt))
+        T result{};
+        if (const auto ec = parse_errc_fn<T>{}(txt, ref{ result }); ec == std::errc{})
         {
-            return *maybe_value;
+            return result;
         }
         else
         {
             std::stringstream ss;
-            ss << "Cannot parse '" << txt << "'";
+            ss << "Cannot parse '" << txt << "': " << std::make_error_code(ec).message();
             throw std::runtime_error{ ss.str() };
         }
     }
 };
 
+template <class Range>
+using contiguous_chars = std::enable_if_t<
+    std::is_convertible_v<decltype(std::data(std::declval<Range&>())), const char*>,
+    decltype(std::size(std::declval<Range&>()))>;
+
+template <class Range>
+using contiguous_char_iterators = std::enable_if_t<is_detected_v<contiguous_range, Range&> && std::is_same_v<range_value_t<Range&>, char>>;
+
+template <class Range>
+using char_range = std::enable_if_t<
+    std::is_convertible_v<Range&&, std::string_view> || is_detected_v<contiguous_chars, Range>
+    || is_detected_v<contiguous_char_iterators, Range>>;
+
+template <class Range, class = char_range<Range>>
+std::string_view to_string_view(Range&& range)
+{
+    if constexpr (std::is_convertible_v<Range&&, std::string_view>)
+    {
+        return std::string_view{ range };
+    }
+    else if constexpr (is_detected_v<contiguous_chars, Range>)
+    {
+        return std::string_view{ std::data(range), std::size(range) };
+    }
+    else
+    {
+        const auto b = std::begin(range);
+        const auto e = std::end(range);
+        return b != e ? std::string_view{ std::addressof(*b), std::size_t(std::distance(b, e)) } : std::string_view{};
+    }
+}
+
+template <class T>
+bool parse_integer_fast(const char* b, const char* e, T& value)
+{
+    bool negative = false;
+    if (b != e && (*b == '+' || (std::is_signed_v<T> && *b == '-')))
+        negative = *b++ == '-';
+
+    if (b == e || e - b > std::numeric_limits<std::uint64_t>::digits10)
+        return false;
+
+    std::uint64_t result = 0;
+    for (; e - b >= 8 && is_eight_digits(load_u64(b)); b += 8)
+    {
+        result = result * 100000000 + parse_eight_digits(load_u64(b));
+    }
+    for (; b != e; ++b)
+    {
+        const auto digit = unsigned(*b) - unsigned('0');
+        if (digit > 9)
+            return false;
+        result = result * 10 + digit;
+    }
+
+    if (result > std::uint64_t(std::numeric_limits<T>::max()) + (negative ? 1 : 0))
+        return false;
+
+    using unsigned_type = std::make_unsigned_t<T>;
+    value = negative ? T(unsigned_type(0) - unsigned_type(result)) : T(result);
+    return true;
+}
+
+template <class T>
+bool parse_token(const char* b, const char* e, T& value)
+{
+    if constexpr (std::is_integral_v<T> && is_from_chars_parsable<T>)
+    {
+        if (parse_integer_fast(b, e, value))
+            return true;
+    }
+    return try_parse_fn<T>{}(std::string_view{ b, std::size_t(e - b) }, ref{ value });
+}
+
+template <class T>
+struct parse_all_fn
+{
+    template <class Range, class Out, class = char_range<Range>>
+    auto operator()(Range&& text, char delimiter, Out out) const -> parse_all_result<Out>
+    {
+        const auto txt = to_string_view(text);
+        const auto begin = txt.data();
+        const auto end = begin + txt.size();
+
+        std::size_t count = 0;
+        for (auto b = begin; b != end;)
+        {
+            const auto token_end = find_byte(b, end, delimiter);
+            T value{};
+            if (!parse_token(b, token_end, value))
+                return { std::move(out), count, std::size_t(b - begin) };
+
+            *out++ = std::move(value);
+            ++count;
+            b = token_end != end ? token_end + 1 : end;
+        }
+        return { std::move(out), count, std::nullopt };
+    }
+};
+
 }  // namespace detail
 
 template <class T>
 static constexpr inline auto try_parse = detail::try_parse_fn<T>{};
 
+template <class T>
+static constexpr inline auto parse_errc = detail::parse_errc_fn<T>{};
+
 template <class T>
 static constexpr inline auto parse = detail::parse_fn<T>{};
 
+template <class T>
+static constexpr inline auto parse_all = detail::parse_all_fn<T>{};
+
 }  // namespace millrind
\ No newline at end of file
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "format.hpp"
+#include "iterator_range.hpp"
+#include "iterators/probe_iterator.hpp"
+#include "output.hpp"
+#include "pipeable.hpp"
+#include "type_traits.hpp"
+
+#if defined(MILLRIND_ENABLE_PROBES) || !defined(NDEBUG)
+#define MILLRIND_PROBES_ENABLED 1
+#else
+#define MILLRIND_PROBES_ENABLED 0
+#endif
+
+namespace millrind
+{
+class probe_registry
+{
+public:
+    static probe_registry& instance()
+    {
+        static probe_registry result;
+        return result;
+    }
+
+    probe_stats& get(std::string_view name)
+    {
+        std::lock_guard lock{ _mutex };
+        return find_or_add(name);
+    }
+
+    probe_stats& get(std::string_view name, std::string_view upstream)
+    {
+        std::lock_guard lock{ _mutex };
+        auto& stats = find_or_add(name);
+        stats.upstream = &find_or_add(upstream);
+        return stats;
+    }
+
+    void reset()
+    {
+        std::lock_guard lock{ _mutex };
+        for (auto& stats : _stats)
+        {
+            stats.elements.store(0, std::memory_order_relaxed);
+            stats.nanoseconds.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::string report() const
+    {
+        static constexpr auto row = MILLRIND_FMT("{:<24} {:>12} {:>9} {:>14} {:>14}\n");
+
+        std::lock_guard lock{ _mutex };
+        std::string result = row("probe", "elements", "ratio", "total ms", "stage ms");
+
+        for (const auto& stats : _stats)
+        {
+            const auto elements = stats.elements.load(std::memory_order_relaxed);
+            const auto total = stats.nanoseconds.load(std::memory_order_relaxed);
+            if (const auto upstream = stats.upstream)
+            {
+                const auto upstream_elements = upstream->elements.load(std::memory_order_relaxed);
+                const auto upstream_total = upstream->nanoseconds.load(std::memory_order_relaxed);
+                result += row(
+                    stats.name,
+                    elements,
+                    format("{:.3f}", upstream_elements > 0 ? double(elements) / double(upstream_elements) : 1.0),
+                    format("{:.3f}", total / 1e6),
+                    format("{:.3f}", (total - std::min(total, upstream_total)) / 1e6));
+            }
+            else
+            {
+                result += row(stats.name, elements, "-", format("{:.3f}", total / 1e6), format("{:.3f}", total / 1e6));
+            }
+        }
+        return result;
+    }
+
+private:
+    probe_registry() = default;
+
+    probe_stats& find_or_add(std::string_view name)
+    {
+        for (auto& stats : _stats)
+        {
+            if (stats.name == name)
+                return stats;
+        }
+        return _stats.emplace_back(std::string{ name });
+    }
+
+    mutable std::mutex _mutex;
+    std::deque<probe_stats> _stats;
+};
+
+namespace seq
+{
+namespace detail
+{
+struct probe_fn
+{
+    template <class Range>
+    auto operator()(Range&& range, std::string_view name, std::string_view upstream = {}) const
+    {
+        if constexpr (!is_detected_v<iterator_t, Range>)
+        {
+            return std::forward<Range>(range);
+        }
+        else if constexpr (MILLRIND_PROBES_ENABLED)
+        {
+            using result_type = probe_iterator<iterator_t<Range>>;
+
+            auto& registry = probe_registry::instance();
+            auto& stats = upstream.empty() ? registry.get(name) : registry.get(name, upstream);
+            return make_range(result_type{ std::begin(range), &stats }, result_type{ std::end(range), &stats });
+        }
+        else
+        {
+            return make_range(std::begin(range), std::end(range));
+        }
+    }
+};
+
+struct instrument_fn
+{
+    template <class Func>
+    auto operator()(pipeable_adaptor<Func> pipeline, std::string_view prefix = "stage") const
+    {
+        if constexpr (MILLRIND_PROBES_ENABLED)
+        {
+            std::size_t index = 0;
+            auto source = pipeable{ probe_fn{} }(stage_name(prefix, index++));
+            return source | wrap(std::move(pipeline), prefix, index);
+        }
+        else
+        {
+            return pipeline;
+        }
+    }
+
+private:
+    static std::string stage_name(std::string_view prefix, std::size_t index)
+    {
+        return format("{}[{}]", prefix, index);
+    }
+
+    template <class F, class G>
+    static auto wrap(pipeable_adaptor<::millrind::detail::function_composition<F, G>> pipeline, std::string_view prefix, std::size_t& index)
+    {
+        auto lhs = wrap(pipeable_adaptor{ std::move(pipeline.func.f) }, prefix, index);
+        auto rhs = wrap(pipeable_adaptor{ std::move(pipeline.func.g) }, prefix, index);
+        return std::move(lhs) | std::move(rhs);
+    }
+
+    template <class Func>
+    static auto wrap(pipeable_adaptor<Func> stage, std::string_view prefix, std::size_t& index)
+    {
+        auto name = stage_name(prefix, index);
+        auto upstream = stage_name(prefix, index - 1);
+        ++index;
+        return std::move(stage) | pipeable{ probe_fn{} }(std::move(name), std::move(upstream));
+    }
+};
+
+struct probe_report_fn
+{
+    std::string operator()() const
+    {
+        return probe_registry::instance().report();
+    }
+};
+
+struct print_probe_report_fn
+{
+    void operator()() const
+    {
+        print(probe_registry::instance().report());
+    }
+};
+
+struct reset_probes_fn
+{
+    void operator()() const
+    {
+        probe_registry::instance().reset();
+    }
+};
+
+}  // namespace detail
+
+static constexpr inline auto probe = pipeable{ detail::probe_fn{} };
+static constexpr inline auto instrument = detail::instrument_fn{};
+static constexpr inline auto probe_report = detail::probe_report_fn{};
+static constexpr inline auto print_probe_report = detail::print_probe_report_fn{};
+static constexpr inline auto reset_probes = detail::reset_probes_fn{};
+
+}  // namespace seq
+
+}  // namespace millrind
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "iterator_range.hpp"
+#include "simd.hpp"
+
+namespace millrind
+{
+namespace detail
+{
+template <class Iter>
+using byte_iterator = std::enable_if_t<sizeof(iter_value_t<Iter>) == 1 && is_detected_v<contiguous_iterator, Iter>>;
+
+template <class T, class Self>
+using pattern_range = std::enable_if_t<!std::is_convertible_v<T, std::string_view> && !std::is_same_v<std::decay_t<T>, Self>>;
+
+template <class Range>
+std::string to_byte_string(Range&& range)
+{
+    std::string result;
+    for (auto&& item : range)
+    {
+        result.push_back(static_cast<char>(item));
+    }
+    return result;
+}
+
+}  // namespace detail
+
+template <class Iter>
+struct pattern_match
+{
+    iterator_range<Iter> range;
+    std::size_t pattern;
+};
+
+class memmem_searcher
+{
+public:
+    explicit memmem_searcher(std::string_view pattern)
+        : _pattern{ pattern }
+    {
+    }
+
+    template <class Range, class = detail::pattern_range<Range, memmem_searcher>>
+    explicit memmem_searcher(Range&& pattern)
+        : _pattern{ detail::to_byte_string(pattern) }
+    {
+    }
+
+    template <class Iter, class = detail::byte_iterator<Iter>>
+    std::pair<Iter, Iter> operator()(Iter first, Iter last) const
+    {
+        if (first == last)
+            return _pattern.empty() ? std::pair{ first, first } : std::pair{ last, last };
+
+        const auto b = reinterpret_cast<const char*>(std::addressof(*first));
+        const auto e = b + (last - first);
+        const auto found = detail::find_substring(b, e, _pattern.data(), _pattern.size());
+        if (found == e)
+            return { last, last };
+
+        const auto it = first + (found - b);
+        return { it, it + _pattern.size() };
+    }
+
+private:
+    std::string _pattern;
+};
+
+class aho_corasick_searcher
+{
+private:
+    using state_type = std::uint32_t;
+
+    static constexpr state_type no_state = std::numeric_limits<state_type>::max();
+
+public:
+    explicit aho_corasick_searcher(std::initializer_list<std::string_view> patterns)
+    {
+        init(patterns);
+    }
+
+    template <class Range, class = detail::pattern_range<Range, aho_corasick_searcher>>
+    explicit aho_corasick_searcher(Range&& patterns)
+    {
+        init(patterns);
+    }
+
+    std::size_t size() const
+    {
+        return _lengths.size();
+    }
+
+    template <class Iter, class = detail::byte_iterator<Iter>>
+    std::pair<Iter, Iter> operator()(Iter first, Iter last) const
+    {
+        if (const auto m = find(first, last))
+            return { std::begin(m->range), std::end(m->range) };
+        return { last, last };
+    }
+
+    template <class Iter>
+    auto find(Iter first, Iter last) const -> std::optional<pattern_match<Iter>>
+    {
+        state_type state = 0;
+        for (auto it = first; it != last; ++it)
+        {
+            state = _delta[state * _classes + _class_of[static_cast<unsigned char>(*it)]];
+            if (const auto pattern = _output[state]; pattern != no_state)
+            {
+                const auto end = std::next(it);
+                return pattern_match<Iter>{ make_range(std::prev(end, _lengths[pattern]), end), pattern };
+            }
+        }
+        return std::nullopt;
+    }
+
+    template <class Range>
+    auto find(Range&& range) const
+    {
+        return find(std::begin(range), std::end(range));
+    }
+
+private:
+    template <class Range>
+    void init(Range&& patterns)
+    {
+        std::vector<std::string> bytes;
+        for (auto&& pattern : patterns)
+        {
+            bytes.push_back(detail::to_byte_string(std::string_view{ pattern }));
+        }
+
+        _class_of.fill(0);
+        _classes = 1;
+        for (const auto& pattern : bytes)
+        {
+            for (unsigned char c : pattern)
+            {
+                if (_class_of[c] == 0)
+                    _class_of[c] = _classes++;
+            }
+        }
+
+        add_state();
+        for (const auto& pattern : bytes)
+        {
+            add_pattern(pattern);
+        }
+        build_links();
+    }
+
+    state_type add_state()
+    {
+        _delta.resize(_delta.size() + _classes, no_state);
+        _output.push_back(no_state);
+        return static_cast<state_type>(_output.size() - 1);
+    }
+
+    void add_pattern(std::string_view pattern)
+    {
+        const auto index = static_cast<state_type>(_lengths.size());
+        _lengths.push_back(pattern.size());
+        if (pattern.empty())
+            return;
+
+        state_type state = 0;
+        for (unsigned char c : pattern)
+        {
+            if (_delta[state * _classes + _class_of[c]] == no_state)
+            {
+                const auto created = add_state();
+                _delta[state * _classes + _class_of[c]] = created;
+            }
+            state = _delta[state * _classes + _class_of[c]];
+        }
+        if (_output[state] == no_state)
+            _output[state] = index;
+    }
+
+    void build_links()
+    {
+        std::vector<state_type> fail(_output.size(), 0);
+        std::queue<state_type> queue;
+
+        for (std::size_t c = 0; c < _classes; ++c)
+        {
+            auto& next = _delta[c];
+            if (next == no_state)
+                next = 0;
+            else
+                queue.push(next);
+        }
+
+        while (!queue.empty())
+        {
+            const auto state = queue.front();
+            queue.pop();
+            for (std::size_t c = 0; c < _classes; ++c)
+            {
+                auto& next = _delta[state * _classes + c];
+                const auto fallback = _delta[fail[state] * _classes + c];
+                if (next == no_state)
+                {
+                    next = fallback;
+                }
+                else
+                {
+                    fail[next] = fallback;
+                    if (_output[next] == no_state)
+                        _output[next] = _output[fallback];
+                    queue.push(next);
+                }
+            }
+        }
+    }
+
+    std::array<state_type, 256> _class_of;
+    std::size_t _classes;
+    std::vector<state_type> _delta;
+    std::vector<state_type> _output;
+    std::vector<std::size_t> _lengths;
+};
+
+}  // namespace millrind
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "aggregate.hpp"
 #include "algorithm.hpp"
 #include "iterator_range.hpp"
 #include "iterators/any_iterator.hpp"
@@ -10,13 +11,20 @@
 #include "iterators/filter_map_iterator.hpp"
 #include "iterators/flat_map_iterator.hpp"
 #include "iterators/generating_iterator.hpp"
+#include "iterators/hash_filter_iterator.hpp"
 #include "iterators/iterate_iterator.hpp"
 #include "iterators/map_iterator.hpp"
+#include "iterators/merge_iterator.hpp"
 #include "iterators/numeric_iterator.hpp"
 #include "iterators/owning_iterator.hpp"
+#include "iterators/parse_iterator.hpp"
 #include "iterators/repeat_iterator.hpp"
+#include "iterators/scan_iterator.hpp"
+#include "iterators/set_operation_iterator.hpp"
+#include "iterators/split_iterator.hpp"
 #include "iterators/stride_iterator.hpp"
 #include "iterators/zip_transform_iterator.hpp"
+#include "parallel.hpp"
 
 namespace millrind
 {
@@ -246,6 +254,27 @@ struct map_fn
     }
 };
 
+struct scan_fn
+{
+    template <class Range, class T, class BinaryFunc = std::plus<>, class Proj = identity>
+    auto operator()(Range&& range, T init, BinaryFunc func = {}, Proj proj = {}) const
+    {
+        return create(
+            std::begin(range),
+            std::end(range),
+            std::move(init),
+            ::millrind::detail::invoke_binary{ std::move(func), identity{}, std::move(proj) });
+    }
+
+    template <class Iter, class T, class Func>
+    auto create(Iter b, Iter e, T init, Func func) const
+    {
+        using result_type = scan_iterator<Func, T, Iter>;
+
+        return make_range(result_type{ func, init, b, e }, result_type{ func, init, e, e });
+    }
+};
+
 template <bool Expected>
 struct filter_fn
 {
@@ -310,6 +339,68 @@ struct filter_map_fn
     }
 };
 
+template <class T>
+struct parse_numbers_fn
+{
+    template <class Range, class = ::millrind::detail::char_range<Range>>
+    auto operator()(Range&& range, char delimiter = ',') const
+    {
+        const auto txt = ::millrind::detail::to_string_view(range);
+        return create(txt.data(), txt.data() + txt.size(), delimiter);
+    }
+
+    auto create(const char* b, const char* e, char delimiter) const
+    {
+        using result_type = parse_iterator<T>;
+
+        return make_range(result_type{ b, b, e, delimiter }, result_type{ b, e, e, delimiter });
+    }
+};
+
+struct split_fn
+{
+    template <class Range, class = ::millrind::detail::char_range<Range>>
+    auto operator()(Range&& range, char delimiter) const
+    {
+        return create(range, ::millrind::detail::byte_delimiter{ delimiter }, true);
+    }
+
+    template <class Range, class = ::millrind::detail::char_range<Range>>
+    auto operator()(Range&& range, std::string_view delimiter) const
+    {
+        return create(range, ::millrind::detail::substring_delimiter{ delimiter }, true);
+    }
+
+    template <class Range, class Delimiter, class = ::millrind::detail::char_range<Range>>
+    static auto create(Range&& range, Delimiter delimiter, bool keep_trailing)
+    {
+        using result_type = split_iterator<Delimiter>;
+
+        const auto txt = ::millrind::detail::to_string_view(range);
+        const auto b = txt.data();
+        const auto e = b + txt.size();
+        return make_range(result_type{ delimiter, b, e, keep_trailing }, result_type{ delimiter, e, e, keep_trailing });
+    }
+};
+
+struct split_any_fn
+{
+    template <class Range, class = ::millrind::detail::char_range<Range>>
+    auto operator()(Range&& range, std::string_view delimiters) const
+    {
+        return split_fn::create(range, ::millrind::detail::any_byte_delimiter{ delimiters }, true);
+    }
+};
+
+struct lines_fn
+{
+    template <class Range, class = ::millrind::detail::char_range<Range>>
+    auto operator()(Range&& range) const
+    {
+        return split_fn::create(range, ::millrind::detail::line_delimiter{}, false);
+    }
+};
+
 struct enumerate_fn
 {
     template <class Range>
@@ -388,6 +479,103 @@ struct zip_fn
     }
 };
 
+struct merge_all_fn
+{
+    template <class Range, class Compare = std::less<>, class Proj = identity>
+    auto operator()(Range&& ranges, Compare compare = {}, Proj proj = {}) const
+    {
+        using iter = iterator_t<range_reference_t<Range>>;
+
+        std::vector<iterator_range<iter>> sources;
+        for (auto&& range : ranges)
+        {
+            sources.emplace_back(std::begin(range), std::end(range));
+        }
+        return create(std::move(sources), ::millrind::detail::invoke_binary{ std::move(compare), std::move(proj) });
+    }
+
+    template <class Iter, class Compare>
+    auto create(std::vector<iterator_range<Iter>> sources, Compare compare) const
+    {
+        using result_type = merge_iterator<Compare, Iter>;
+        return make_range(result_type{ compare, std::move(sources) }, result_type{ compare, {} });
+    }
+};
+
+struct merge_fn
+{
+    template <class... Args>
+    auto operator()(Args&&... args) const
+    {
+        constexpr auto count = leading_ranges<Args...>();
+        static_assert(count > 0 && sizeof...(Args) - count <= 2, "seq::merge: (ranges..., [compare], [proj]) expected");
+
+        return create(std::forward_as_tuple(std::forward<Args>(args)...), std::make_index_sequence<count>{});
+    }
+
+private:
+    template <class... Args>
+    static constexpr std::size_t leading_ranges()
+    {
+        std::size_t result = 0;
+        bool leading = true;
+        for (bool is_range : { is_detected_v<iterator_t, Args>... })
+        {
+            leading = leading && is_range;
+            result += leading ? 1 : 0;
+        }
+        return result;
+    }
+
+    template <class Tuple, size_t... I>
+    auto create(Tuple args, std::index_sequence<I...>) const
+    {
+        using iter = std::common_type_t<iterator_t<std::tuple_element_t<I, Tuple>>...>;
+        constexpr auto count = sizeof...(I);
+
+        std::vector<iterator_range<iter>> sources{ iterator_range<iter>{ iter{ std::begin(std::get<I>(args)) },
+                                                                         iter{ std::end(std::get<I>(args)) } }... };
+        return merge_all_fn{}.create(
+            std::move(sources),
+            ::millrind::detail::invoke_binary{ get_or<count>(args, std::less<>{}), get_or<count + 1>(args, identity{}) });
+    }
+
+    template <size_t Index, class Tuple, class Default>
+    static auto get_or(Tuple& args, Default def)
+    {
+        if constexpr (Index < std::tuple_size_v<Tuple>)
+            return std::decay_t<std::tuple_element_t<Index, Tuple>>{ std::get<Index>(args) };
+        else
+            return def;
+    }
+};
+
+template <class Tag>
+struct set_operation_fn
+{
+    template <class Range1, class Range2, class Compare = std::less<>, class Proj1 = identity, class Proj2 = identity>
+    auto operator()(Range1&& range1, Range2&& range2, Compare compare = {}, Proj1 proj1 = {}, Proj2 proj2 = {}) const
+    {
+        return create(
+            std::begin(range1),
+            std::end(range1),
+            std::begin(range2),
+            std::end(range2),
+            std::move(compare),
+            std::move(proj1),
+            std::move(proj2));
+    }
+
+    template <class Iter1, class Iter2, class Compare, class Proj1, class Proj2>
+    auto create(Iter1 b1, Iter1 e1, Iter2 b2, Iter2 e2, Compare compare, Proj1 proj1, Proj2 proj2) const
+    {
+        using result_type = set_operation_iterator<Tag, Compare, Proj1, Proj2, Iter1, Iter2>;
+
+        return make_range(
+            result_type{ compare, proj1, proj2, b1, e1, b2, e2 }, result_type{ compare, proj1, proj2, e1, e1, e2, e2 });
+    }
+};
+
 struct adjacent_fn
 {
     template <class Range>
@@ -501,11 +689,206 @@ struct front_fn
     }
 };
 
+template <class Erase, class Iter, class Proj, class Set>
+auto make_hash_filter(Iter b, Iter e, Proj proj, Set set)
+{
+    using result_type = hash_filter_iterator<Proj, Set, Erase, Iter>;
+    return make_range(result_type{ proj, std::make_shared<Set>(std::move(set)), b, e }, result_type{ proj, nullptr, e, e });
+}
+
+struct distinct_fn
+{
+    template <class Range, class Proj = identity, class Hash = ::millrind::detail::default_hash>
+    auto operator()(Range&& range, Proj proj = {}, Hash hash = {}) const
+    {
+        using key_type = std::decay_t<decltype(call(proj, *std::begin(range)))>;
+        return make_hash_filter<std::false_type>(
+            std::begin(range), std::end(range), std::move(proj), flat_hash_set<key_type, Hash>{ 0, std::move(hash) });
+    }
+};
+
+template <class Erase>
+struct hash_set_operation_fn
+{
+    template <class Range, class Other, class Proj = identity, class Hash = ::millrind::detail::default_hash>
+    auto operator()(Range&& range, Other&& other, Proj proj = {}, Hash hash = {}) const
+    {
+        using key_type = std::decay_t<decltype(call(proj, *std::begin(range)))>;
+        flat_hash_set<key_type, Hash> set{ 0, std::move(hash) };
+        for (auto&& item : other)
+        {
+            set.insert(call(proj, std::forward<decltype(item)>(item)));
+        }
+        return make_hash_filter<Erase>(std::begin(range), std::end(range), std::move(proj), std::move(set));
+    }
+};
+
+struct top_k_fn
+{
+    template <class Range, class Compare = std::less<>, class Proj = identity>
+    auto operator()(Range&& range, std::size_t k, Compare compare = {}, Proj proj = {}) const
+    {
+        std::vector<range_value_t<Range>> heap;
+        if constexpr (is_detected_v<random_access_range, Range>)
+            heap.reserve(std::min<std::size_t>(k, std::distance(std::begin(range), std::end(range))));
+
+        const auto cmp = ::millrind::detail::invoke_binary{ ref(compare), ref(proj) };
+        push(heap, std::begin(range), std::end(range), k, cmp);
+        std::sort_heap(std::begin(heap), std::end(heap), cmp);
+        return heap;
+    }
+
+    template <class T, class Iter, class Compare>
+    static void push(std::vector<T>& heap, Iter b, Iter e, std::size_t k, const Compare& compare)
+    {
+        if (k == 0)
+            return;
+
+        for (; b != e; ++b)
+        {
+            if (heap.size() < k)
+            {
+                heap.push_back(*b);
+                std::push_heap(std::begin(heap), std::end(heap), compare);
+            }
+            else if (compare(*b, heap.front()))
+            {
+                std::pop_heap(std::begin(heap), std::end(heap), compare);
+                heap.back() = *b;
+                std::push_heap(std::begin(heap), std::end(heap), compare);
+            }
+        }
+    }
+};
+
+struct par_top_k_fn
+{
+    template <class Range, class Compare = std::less<>, class Proj = identity>
+    auto operator()(Range&& partitions, std::size_t k, Compare compare = {}, Proj proj = {}) const
+    {
+        auto partial = ::millrind::detail::parallel_transform(
+            partitions, [&](auto&& partition) { return top_k_fn{}(partition, k, ref(compare), ref(proj)); });
+
+        using value_type = range_value_t<typename decltype(partial)::value_type>;
+        const auto cmp = ::millrind::detail::invoke_binary{ ref(compare), ref(proj) };
+
+        std::vector<value_type> heap;
+        for (auto& part : partial)
+        {
+            top_k_fn::push(heap, std::make_move_iterator(std::begin(part)), std::make_move_iterator(std::end(part)), k, cmp);
+        }
+        std::sort_heap(std::begin(heap), std::end(heap), cmp);
+        return heap;
+    }
+};
+
+struct group_by_fn
+{
+    template <class Range, class KeyProj, class... Aggs>
+    auto operator()(Range&& range, KeyProj key_proj, Aggs... aggs) const
+    {
+        auto table = make_table<range_reference_t<Range>>(key_proj, aggs...);
+        accumulate(table, std::begin(range), std::end(range), key_proj, aggs...);
+        return finish(std::move(table), aggs...);
+    }
+
+    template <class Reference, class KeyProj, class... Aggs>
+    static auto make_table(const KeyProj& key_proj, const Aggs&... aggs)
+    {
+        using key_type = std::decay_t<decltype(call(key_proj, std::declval<Reference>()))>;
+        using state_type = std::tuple<decltype(aggs.template init<Reference>())...>;
+        return flat_hash_map<key_type, state_type, ::millrind::detail::default_hash>{};
+    }
+
+    template <class Table, class Iter, class KeyProj, class... Aggs>
+    static void accumulate(Table& table, Iter b, Iter e, const KeyProj& key_proj, const Aggs&... aggs)
+    {
+        using value_type = typename Table::value_type;
+        using state_type = typename value_type::second_type;
+
+        for (; b != e; ++b)
+        {
+            decltype(auto) item = *b;
+            const auto& key = call(key_proj, item);
+            auto& state = table.find_or_emplace(key, [&]() {
+                return value_type{ key, state_type{ aggs.template init<iter_reference_t<Iter>>()... } };
+            }).first->second;
+            std::apply([&](auto&... states) { (aggs.add(states, item), ...); }, state);
+        }
+    }
+
+    template <class Table, class... Aggs>
+    static void merge(Table& table, Table&& other, const Aggs&... aggs)
+    {
+        for (auto& [key, state] : other)
+        {
+            const auto [slot, inserted] = table.find_or_emplace(key, [&]() {
+                return typename Table::value_type{ std::move(key), std::move(state) };
+            });
+            if (!inserted)
+                merge_states(slot->second, std::move(state), std::index_sequence_for<Aggs...>{}, aggs...);
+        }
+    }
+
+    template <class Table, class... Aggs>
+    static auto finish(Table table, const Aggs&... aggs)
+    {
+        using result_type = decltype(result_type_of<typename Table::value_type, Aggs...>(std::index_sequence_for<Aggs...>{}));
+
+        std::vector<result_type> result;
+        result.reserve(table.size());
+        for (auto& [key, state] : table)
+        {
+            result.push_back(std::apply(
+                [&](auto&... states) { return result_type{ std::move(key), aggs.result(std::move(states))... }; },
+                state));
+        }
+        return owned_fn{}(std::move(result));
+    }
+
+private:
+    template <class Value, class... Aggs, size_t... I>
+    static auto result_type_of(std::index_sequence<I...>) -> std::tuple<
+        typename Value::first_type,
+        decltype(std::declval<const Aggs&>().result(std::declval<std::tuple_element_t<I, typename Value::second_type>>()))...>;
+
+    template <class State, size_t... I, class... Aggs>
+    static void merge_states(State& state, State&& other, std::index_sequence<I...>, const Aggs&... aggs)
+    {
+        (aggs.merge(std::get<I>(state), std::move(std::get<I>(other))), ...);
+    }
+};
+
+struct par_group_by_fn
+{
+    template <class Range, class KeyProj, class... Aggs>
+    auto operator()(Range&& range, KeyProj key_proj, Aggs... aggs) const
+    {
+        MILLRIND_CHECK_CONSTRAINT("par_group_by", range, random_access_range);
+
+        auto partitions = ::millrind::detail::split_evenly(
+            std::begin(range), std::end(range), ::millrind::detail::hardware_concurrency());
+
+        auto tables = ::millrind::detail::parallel_transform(partitions, [&](const auto& partition) {
+            auto table = group_by_fn::make_table<range_reference_t<Range>>(key_proj, aggs...);
+            group_by_fn::accumulate(table, std::begin(partition), std::end(partition), key_proj, aggs...);
+            return table;
+        });
+
+        for (auto it = std::next(std::begin(tables)); it != std::end(tables); ++it)
+        {
+            group_by_fn::merge(tables.front(), std::move(*it), aggs...);
+        }
+        return group_by_fn::finish(std::move(tables.front()), aggs...);
+    }
+};
+
 }  // namespace detail
 
 static constexpr inline auto iterate = pipeable{ detail::iterate_fn{} };
 static constexpr inline auto map = pipeable{ detail::map_fn{} };
 static constexpr inline auto transform = map;
+static constexpr inline auto scan = pipeable{ detail::scan_fn{} };
 static constexpr inline auto take_if = pipeable{ detail::filter_fn<true>{} };
 static constexpr inline auto drop_if = pipeable{ detail::filter_fn<false>{} };
 static constexpr inline auto filter = take_if;
@@ -514,6 +897,13 @@ static constexpr inline auto transform_join = flat_map;
 static constexpr inline auto flatten = pipeable{ detail::flatten_fn{} };
 static constexpr inline auto join = flatten;
 static constexpr inline auto filter_map = pipeable{ detail::filter_map_fn{} };
+
+template <class T>
+static constexpr inline auto parse_numbers = pipeable{ detail::parse_numbers_fn<T>{} };
+
+static constexpr inline auto split = pipeable{ detail::split_fn{} };
+static constexpr inline auto split_any = pipeable{ detail::split_any_fn{} };
+static constexpr inline auto lines = pipeable{ detail::lines_fn{} };
 static constexpr inline auto transform_maybe = filter_map;
 static constexpr inline auto enumerate = pipeable{ detail::enumerate_fn{} };
 static constexpr inline auto reverse = pipeable{ detail::reverse_fn{} };
@@ -548,10 +938,27 @@ static constexpr inline auto for_each = pipeable{ detail::for_each_fn{} };
 
 static constexpr inline auto front = pipeable{ detail::front_fn{} };
 
+static constexpr inline auto set_union = pipeable{ detail::set_operation_fn<set_union_tag>{} };
+static constexpr inline auto set_intersection = pipeable{ detail::set_operation_fn<set_intersection_tag>{} };
+static constexpr inline auto set_difference = pipeable{ detail::set_operation_fn<set_difference_tag>{} };
+static constexpr inline auto set_symmetric_difference = pipeable{ detail::set_operation_fn<set_symmetric_difference_tag>{} };
+
+static constexpr inline auto distinct = pipeable{ detail::distinct_fn{} };
+static constexpr inline auto intersect_with = pipeable{ detail::hash_set_operation_fn<std::true_type>{} };
+static constexpr inline auto except = pipeable{ detail::hash_set_operation_fn<std::false_type>{} };
+
+static constexpr inline auto group_by = pipeable{ detail::group_by_fn{} };
+static constexpr inline auto par_group_by = pipeable{ detail::par_group_by_fn{} };
+
+static constexpr inline auto top_k = pipeable{ detail::top_k_fn{} };
+static constexpr inline auto par_top_k = pipeable{ detail::par_top_k_fn{} };
+
 static constexpr inline auto zip = detail::zip_fn{};
 static constexpr inline auto zip_transform = detail::zip_transform_fn{};
 
 static constexpr inline auto concat = detail::concat_fn{};
+static constexpr inline auto merge = detail::merge_fn{};
+static constexpr inline auto merge_all = pipeable{ detail::merge_all_fn{} };
 static constexpr inline auto iota = detail::iota_fn{};
 static constexpr inline auto owned = detail::owned_fn{};
 static constexpr inline auto repeat = detail::repeat_fn{};
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace millrind
+{
+namespace detail
+{
+inline const char* find_byte(const char* b, const char* e, char c)
+{
+    const auto result = b != e ? static_cast<const char*>(std::memchr(b, c, e - b)) : nullptr;
+    return result ? result : e;
+}
+
+inline int count_trailing_zeros(unsigned mask)
+{
+    return __builtin_ctz(mask);
+}
+
+inline const char* find_any_byte(const char* b, const char* e, std::string_view chars)
+{
+    if (chars.size() == 1)
+        return find_byte(b, e, chars[0]);
+
+#if defined(__SSE2__)
+    for (; e - b >= 16; b += 16)
+    {
+        const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+        auto hits = _mm_setzero_si128();
+        for (char c : chars)
+        {
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, _mm_set1_epi8(c)));
+        }
+        if (const auto mask = static_cast<unsigned>(_mm_movemask_epi8(hits)))
+            return b + count_trailing_zeros(mask);
+    }
+#endif
+
+    for (; b != e; ++b)
+    {
+        if (std::memchr(chars.data(), static_cast<unsigned char>(*b), chars.size()))
+            return b;
+    }
+    return e;
+}
+
+inline std::uint64_t load_u64(const char* p)
+{
+    std::uint64_t result;
+    std::memcpy(&result, p, sizeof(result));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    result = __builtin_bswap64(result);
+#endif
+    return result;
+}
+
+inline bool is_eight_digits(std::uint64_t chunk)
+{
+    return ((chunk & 0xF0F0F0F0F0F0F0F0) | (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+}
+
+inline std::uint32_t parse_eight_digits(std::uint64_t chunk)
+{
+    constexpr std::uint64_t mask = 0x000000FF000000FF;
+    constexpr std::uint64_t mul1 = 100 + (1000000ULL << 32);
+    constexpr std::uint64_t mul2 = 1 + (10000ULL << 32);
+    chunk -= 0x3030303030303030;
+    chunk = (chunk * 10) + (chunk >> 8);
+    return std::uint32_t((((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32);
+}
+
+inline const char* find_substring(const char* b, const char* e, const char* needle, std::size_t size)
+{
+    if (size == 0)
+        return b;
+    if (std::size_t(e - b) < size)
+        return e;
+    if (size == 1)
+        return find_byte(b, e, needle[0]);
+
+    const char* const last_start = e - size;
+
+#if defined(__AVX2__)
+    const auto first = _mm256_set1_epi8(needle[0]);
+    const auto last = _mm256_set1_epi8(needle[size - 1]);
+    for (; b + 32 <= last_start + 1; b += 32)
+    {
+        const auto block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+        const auto block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + size - 1));
+        auto mask = static_cast<unsigned>(
+            _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+        for (; mask != 0; mask &= mask - 1)
+        {
+            const auto offset = count_trailing_zeros(mask);
+            if (std::memcmp(b + offset + 1, needle + 1, size - 2) == 0)
+                return b + offset;
+        }
+    }
+#elif defined(__SSE2__)
+    const auto first = _mm_set1_epi8(needle[0]);
+    const auto last = _mm_set1_epi8(needle[size - 1]);
+    for (; b + 16 <= last_start + 1; b += 16)
+    {
+        const auto block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+        const auto block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + size - 1));
+        auto mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+        for (; mask != 0; mask &= mask - 1)
+        {
+            const auto offset = count_trailing_zeros(mask);
+            if (std::memcmp(b + offset + 1, needle + 1, size - 2) == 0)
+                return b + offset;
+        }
+    }
+#endif
+
+    for (; b <= last_start; ++b)
+    {
+        b = find_byte(b, last_start + 1, needle[0]);
+        if (b > last_start)
+            break;
+        if (b[size - 1] == needle[size - 1] && std::memcmp(b + 1, needle + 1, size - 2) == 0)
+            return b;
+    }
+    return e;
+}
+
+}  // namespace detail
+}  // namespace millrind
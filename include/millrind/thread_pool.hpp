@@ -0,0 +1,245 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "parallel.hpp"
+
+namespace millrind
+{
+class thread_pool
+{
+public:
+    explicit thread_pool(std::size_t workers = detail::hardware_concurrency())
+        : _stop{ false }
+    {
+        workers = std::max<std::size_t>(workers, 1);
+        _threads.reserve(workers);
+        for (std::size_t i = 0; i < workers; ++i)
+        {
+            _threads.emplace_back([this] { run(); });
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard lock{ _mutex };
+            _stop = true;
+        }
+        _wakeup.notify_all();
+        for (auto& thread : _threads)
+        {
+            thread.join();
+        }
+    }
+
+    std::size_t size() const
+    {
+        return _threads.size();
+    }
+
+    template <class Func>
+    void post(Func func)
+    {
+        {
+            std::lock_guard lock{ _mutex };
+            _tasks.emplace_back(std::move(func));
+        }
+        _wakeup.notify_one();
+    }
+
+    template <class Func>
+    auto submit(Func func) -> std::future<std::invoke_result_t<Func&>>
+    {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Func&>()>>(std::move(func));
+        auto result = task->get_future();
+        post([task] { (*task)(); });
+        return result;
+    }
+
+private:
+    void run()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock lock{ _mutex };
+                _wakeup.wait(lock, [this] { return _stop || !_tasks.empty(); });
+                if (_tasks.empty())
+                    return;
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex _mutex;
+    std::condition_variable _wakeup;
+    std::deque<std::function<void()>> _tasks;
+    bool _stop;
+    std::vector<std::thread> _threads;
+};
+
+class work_stealing_pool
+{
+public:
+    explicit work_stealing_pool(std::size_t workers = detail::hardware_concurrency())
+        : _queues(std::max<std::size_t>(workers, 1))
+        , _idle{ 0 }
+        , _next{ 0 }
+        , _stop{ false }
+    {
+        _threads.reserve(_queues.size());
+        for (std::size_t i = 0; i < _queues.size(); ++i)
+        {
+            _threads.emplace_back([this, i] { run(i); });
+        }
+    }
+
+    work_stealing_pool(const work_stealing_pool&) = delete;
+    work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+    ~work_stealing_pool()
+    {
+        {
+            std::lock_guard lock{ _mutex };
+            _stop = true;
+        }
+        _wakeup.notify_all();
+        for (auto& thread : _threads)
+        {
+            thread.join();
+        }
+    }
+
+    std::size_t size() const
+    {
+        return _threads.size();
+    }
+
+    template <class Func>
+    void post(Func func)
+    {
+        const auto index = current_worker().first == this
+            ? current_worker().second
+            : _next.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+        {
+            std::lock_guard lock{ _queues[index].mutex };
+            _queues[index].tasks.emplace_back(std::move(func));
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_idle.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard lock{ _mutex };
+            _wakeup.notify_one();
+        }
+    }
+
+    template <class Func>
+    auto submit(Func func) -> std::future<std::invoke_result_t<Func&>>
+    {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Func&>()>>(std::move(func));
+        auto result = task->get_future();
+        post([task] { (*task)(); });
+        return result;
+    }
+
+private:
+    struct worker_queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    static std::pair<const work_stealing_pool*, std::size_t>& current_worker()
+    {
+        thread_local std::pair<const work_stealing_pool*, std::size_t> worker{ nullptr, 0 };
+        return worker;
+    }
+
+    bool try_pop(std::size_t index, std::function<void()>& task)
+    {
+        auto& queue = _queues[index];
+        std::lock_guard lock{ queue.mutex };
+        if (queue.tasks.empty())
+            return false;
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool try_steal(std::size_t index, std::function<void()>& task)
+    {
+        for (std::size_t i = 1; i < _queues.size(); ++i)
+        {
+            auto& queue = _queues[(index + i) % _queues.size()];
+            std::lock_guard lock{ queue.mutex };
+            if (!queue.tasks.empty())
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool try_claim(std::size_t index, std::function<void()>& task)
+    {
+        return try_pop(index, task) || try_steal(index, task);
+    }
+
+    bool park(std::size_t index, std::function<void()>& task)
+    {
+        std::unique_lock lock{ _mutex };
+        _idle.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!try_claim(index, task))
+        {
+            if (_stop)
+            {
+                _idle.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+            _wakeup.wait(lock);
+        }
+        _idle.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void run(std::size_t index)
+    {
+        current_worker() = { this, index };
+        while (true)
+        {
+            std::function<void()> task;
+            if (!try_claim(index, task) && !park(index, task))
+                return;
+            task();
+        }
+    }
+
+    std::vector<worker_queue> _queues;
+    std::mutex _mutex;
+    std::condition_variable _wakeup;
+    std::atomic<std::size_t> _idle;
+    std::atomic<std::size_t> _next;
+    bool _stop;
+    std::vector<std::thread> _threads;
+};
+
+}  // namespace millrind
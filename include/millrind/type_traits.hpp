@@ -1,7 +1,11 @@
 #pragma once
 
+#include <cstddef>
 #include <iterator>
+#include <string>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
 namespace millrind
 {
@@ -97,6 +101,35 @@ using bidirectional_range = bidirectional_iterator<iterator_t<T>>;
 template <class T>
 using random_access_range = random_access_iterator<iterator_t<T>>;
 
+namespace detail
+{
+template <class Iter, class... Containers>
+constexpr bool is_iterator_of
+    = ((std::is_same_v<Iter, typename Containers::iterator> || std::is_same_v<Iter, typename Containers::const_iterator>) || ...);
+
+}  // namespace detail
+
+template <class T>
+struct is_contiguous_iterator
+    : std::bool_constant<
+          std::is_pointer_v<T>
+          || detail::is_iterator_of<
+              T,
+              std::string,
+              std::string_view,
+              std::vector<char>,
+              std::vector<signed char>,
+              std::vector<unsigned char>,
+              std::vector<std::byte>>>
+{
+};
+
+template <class T>
+using contiguous_iterator = std::enable_if_t<is_contiguous_iterator<T>::value>;
+
+template <class T>
+using contiguous_range = contiguous_iterator<iterator_t<T>>;
+
 template <class T, class U = T>
 using equality_comparable = decltype(std::declval<T>() == std::declval<U>());
 
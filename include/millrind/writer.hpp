@@ -0,0 +1,265 @@
+#pragma once
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "format.hpp"
+#include "output.hpp"
+
+namespace millrind
+{
+class buffered_writer;
+
+namespace detail
+{
+struct writer_appender
+{
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    buffered_writer* writer;
+
+    writer_appender& operator*()
+    {
+        return *this;
+    }
+
+    writer_appender& operator++()
+    {
+        return *this;
+    }
+
+    writer_appender& operator++(int)
+    {
+        return *this;
+    }
+
+    writer_appender& operator=(char c);
+};
+
+inline writer_appender put(writer_appender out, std::string_view txt);
+
+inline writer_appender put_fill(writer_appender out, std::size_t count, char c);
+
+}  // namespace detail
+
+class buffered_writer
+{
+public:
+    static constexpr std::size_t default_capacity = 1 << 16;
+
+    explicit buffered_writer(int fd, std::size_t capacity = default_capacity)
+        : _fd{ fd }
+        , _file{ nullptr }
+        , _buffer{ new char[std::max<std::size_t>(capacity, 1)] }
+        , _capacity{ std::max<std::size_t>(capacity, 1) }
+        , _size{ 0 }
+    {
+    }
+
+    explicit buffered_writer(std::FILE* file, std::size_t capacity = default_capacity)
+        : _fd{ -1 }
+        , _file{ file }
+        , _buffer{ new char[std::max<std::size_t>(capacity, 1)] }
+        , _capacity{ std::max<std::size_t>(capacity, 1) }
+        , _size{ 0 }
+    {
+    }
+
+    buffered_writer(const buffered_writer&) = delete;
+    buffered_writer& operator=(const buffered_writer&) = delete;
+
+    ~buffered_writer()
+    {
+        try
+        {
+            flush();
+        }
+        catch (const std::system_error&)
+        {
+        }
+    }
+
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    std::size_t capacity() const
+    {
+        return _capacity;
+    }
+
+    void write(std::string_view txt)
+    {
+        if (txt.size() > _capacity - _size)
+        {
+            flush_buffer();
+            if (txt.size() >= _capacity)
+                return sink(txt.data(), txt.size());
+        }
+        std::memcpy(_buffer.get() + _size, txt.data(), txt.size());
+        _size += txt.size();
+    }
+
+    void put(char c)
+    {
+        if (_size == _capacity)
+            flush_buffer();
+        _buffer[_size++] = c;
+    }
+
+    void fill(std::size_t count, char c)
+    {
+        while (count > 0)
+        {
+            if (_size == _capacity)
+                flush_buffer();
+            const auto n = std::min(count, _capacity - _size);
+            std::memset(_buffer.get() + _size, c, n);
+            _size += n;
+            count -= n;
+        }
+    }
+
+    template <class T>
+    buffered_writer& operator<<(const T& item)
+    {
+        detail::write_arg(detail::writer_appender{ this }, detail::format_spec{}, item);
+        return *this;
+    }
+
+    template <class Iter, class Proj>
+    buffered_writer& operator<<(const delimited<Iter, Proj>& item)
+    {
+        for (auto it = item.begin; it != item.end; ++it)
+        {
+            if (it != item.begin)
+                write(item.separator);
+            *this << std::invoke(item.proj, *it);
+        }
+        return *this;
+    }
+
+    void flush()
+    {
+        flush_buffer();
+        if (_file && std::fflush(_file) != 0)
+            throw std::system_error{ errno, std::generic_category(), "cannot flush" };
+    }
+
+private:
+    void flush_buffer()
+    {
+        if (_size == 0)
+            return;
+        const auto size = std::exchange(_size, 0);
+        sink(_buffer.get(), size);
+    }
+
+    void sink(const char* data, std::size_t size)
+    {
+        if (_file)
+        {
+            if (std::fwrite(data, 1, size, _file) != size)
+                throw std::system_error{ errno, std::generic_category(), "cannot write" };
+            return;
+        }
+
+        while (size > 0)
+        {
+            const auto written = ::write(_fd, data, size);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error{ errno, std::generic_category(), "cannot write" };
+            }
+            data += written;
+            size -= std::size_t(written);
+        }
+    }
+
+    int _fd;
+    std::FILE* _file;
+    std::unique_ptr<char[]> _buffer;
+    std::size_t _capacity;
+    std::size_t _size;
+};
+
+struct writer_iterator
+{
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    buffered_writer* writer;
+    std::string_view separator;
+
+    writer_iterator(buffered_writer& writer, std::string_view separator = {})
+        : writer{ &writer }
+        , separator{ separator }
+    {
+    }
+
+    writer_iterator& operator*()
+    {
+        return *this;
+    }
+
+    writer_iterator& operator++()
+    {
+        return *this;
+    }
+
+    writer_iterator& operator++(int)
+    {
+        return *this;
+    }
+
+    template <class T>
+    writer_iterator& operator=(const T& item)
+    {
+        *writer << item;
+        writer->write(separator);
+        return *this;
+    }
+};
+
+namespace detail
+{
+inline writer_appender& writer_appender::operator=(char c)
+{
+    writer->put(c);
+    return *this;
+}
+
+inline writer_appender put(writer_appender out, std::string_view txt)
+{
+    out.writer->write(txt);
+    return out;
+}
+
+inline writer_appender put_fill(writer_appender out, std::size_t count, char c)
+{
+    out.writer->fill(count, c);
+    return out;
+}
+
+}  // namespace detail
+
+}  // namespace millrind
@@ -0,0 +1,133 @@
+#include "allocation_counter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+thread_local millrind::testing::allocation_stats stats;
+
+void* allocate(std::size_t size)
+{
+    ++stats.allocations;
+    stats.bytes += size;
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc{};
+}
+
+void* allocate_aligned(std::size_t size, std::align_val_t alignment)
+{
+    ++stats.allocations;
+    stats.bytes += size;
+    const auto align = static_cast<std::size_t>(alignment);
+    if (void* ptr = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return ptr;
+    throw std::bad_alloc{};
+}
+
+void deallocate(void* ptr) noexcept
+{
+    if (!ptr)
+        return;
+    ++stats.deallocations;
+    std::free(ptr);
+}
+
+}  // namespace
+
+namespace millrind
+{
+namespace testing
+{
+allocation_stats thread_allocation_stats()
+{
+    return stats;
+}
+
+}  // namespace testing
+}  // namespace millrind
+
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return allocate(size);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return allocate(size);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return nullptr;
+    }
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocate_aligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocate_aligned(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    deallocate(ptr);
+}
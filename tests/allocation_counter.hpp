@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+
+namespace millrind
+{
+namespace testing
+{
+struct allocation_stats
+{
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+    std::size_t bytes = 0;
+};
+
+allocation_stats thread_allocation_stats();
+
+class scoped_allocation_counter
+{
+public:
+    scoped_allocation_counter()
+        : _start{ thread_allocation_stats() }
+    {
+    }
+
+    std::size_t allocations() const
+    {
+        return thread_allocation_stats().allocations - _start.allocations;
+    }
+
+    std::size_t deallocations() const
+    {
+        return thread_allocation_stats().deallocations - _start.deallocations;
+    }
+
+    std::size_t bytes() const
+    {
+        return thread_allocation_stats().bytes - _start.bytes;
+    }
+
+private:
+    allocation_stats _start;
+};
+
+}  // namespace testing
+}  // namespace millrind
@@ -0,0 +1,75 @@
+#include <catch.hpp>
+#include <millrind/format.hpp>
+#include <millrind/output.hpp>
+#include <millrind/seq.hpp>
+
+#include "allocation_counter.hpp"
+
+using namespace millrind;
+using testing::scoped_allocation_counter;
+
+SCENARIO("map, filter and zip over vectors do not allocate", "[allocation]")
+{
+    const std::vector<int> a(seq::iota(0, 1000));
+    const std::vector<int> b(seq::iota(1000, 2000));
+
+    const scoped_allocation_counter counter;
+    long long sum = 0;
+    for (const auto x : a | seq::map([](int x) { return 3 * x; }) | seq::filter([](int x) { return x % 2 == 0; }))
+    {
+        sum += x;
+    }
+    for (const auto [x, y] : seq::zip(a, b))
+    {
+        sum += x * y;
+    }
+    seq::zip_transform(std::multiplies<>{}, a, b) | seq::for_each([&](int x) { sum -= x; });
+
+    REQUIRE(sum != 0);
+    REQUIRE(counter.allocations() == 0);
+}
+
+SCENARIO("iterable construction stays within budget", "[allocation]")
+{
+    const std::vector<int> values(seq::iota(0, 100));
+
+    const scoped_allocation_counter counter;
+    const iterable<int> range = values | seq::map([](int x) { return x + 1; });
+    REQUIRE(counter.allocations() <= 4);
+}
+
+SCENARIO("format stays within budget", "[allocation]")
+{
+    static constexpr auto fmt = MILLRIND_FMT("{}:{:>6}:{:.2f}");
+    const compiled_format compiled{ "{}:{:>6}:{:.2f}" };
+    char buffer[64];
+
+    const scoped_allocation_counter counter;
+    REQUIRE(format("{}:{:>6}:{:.2f}", "key", 42, 1.5) == "key:    42:1.50");
+    REQUIRE(fmt("key", 42, 1.5).size() == 15);
+    REQUIRE(compiled("key", 42, 1.5).size() == 15);
+    REQUIRE(counter.allocations() <= 3);
+
+    const scoped_allocation_counter buffer_counter;
+    format_to(buffer, fmt, "a fairly long key that would not fit in SSO", 42, 1.5);
+    format_to(buffer, compiled, "key", 42, 1.5);
+    format_to(buffer, "{}:{}", 1, 2);
+    REQUIRE(buffer_counter.allocations() == 0);
+
+    const scoped_allocation_counter str_counter;
+    REQUIRE(str_cat("metric.", "a fairly long metric name.", 123456789, '.', 2.5).size() == 46);
+    REQUIRE(str_counter.allocations() == 1);
+
+    const scoped_allocation_counter stream_free_counter;
+    REQUIRE(str("metric.", "a fairly long metric name.", 123456789, '.', 2.5).size() == 46);
+    REQUIRE(stream_free_counter.allocations() == 1);
+}
+
+SCENARIO("owned allocates once", "[allocation]")
+{
+    std::vector<int> values(seq::iota(0, 100));
+
+    const scoped_allocation_counter counter;
+    const auto range = seq::owned(std::move(values));
+    REQUIRE(counter.allocations() == 1);
+}
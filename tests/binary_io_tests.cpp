@@ -0,0 +1,61 @@
+#include <catch.hpp>
+#include <cstdio>
+#include <list>
+#include <millrind/binary_io.hpp>
+
+using namespace millrind;
+
+namespace
+{
+struct sample
+{
+    int id;
+    double value;
+
+    friend bool operator==(const sample& lhs, const sample& rhs)
+    {
+        return lhs.id == rhs.id && lhs.value == rhs.value;
+    }
+};
+
+std::string temp_path()
+{
+    std::string path = "/tmp/millrind_binary_XXXXXX";
+    ::close(::mkstemp(path.data()));
+    return path;
+}
+
+}  // namespace
+
+SCENARIO("write_binary and read_binary round trip contiguous ranges", "[binary_io]")
+{
+    const auto path = temp_path();
+    const std::vector<sample> samples{ { 1, 0.5 }, { 2, -1.25 }, { 3, 1e10 } };
+
+    REQUIRE((samples | seq::write_binary(path)) == 3);
+    REQUIRE(std::vector<sample>(seq::read_binary<sample>(path)) == samples);
+
+    const auto mapped = seq::mapped_binary<sample>(path);
+    REQUIRE(std::end(mapped) - std::begin(mapped) == 3);
+    REQUIRE(std::begin(mapped)[1] == samples[1]);
+
+    using odd_sized = std::array<char, 5>;
+    REQUIRE_THROWS_AS(seq::read_binary<odd_sized>(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+SCENARIO("write_binary buffers non-contiguous ranges", "[binary_io]")
+{
+    const auto path = temp_path();
+    const std::list<std::int32_t> values{ 5, 6, 7 };
+
+    REQUIRE((seq::iota(0, 100000) | seq::write_binary(path)) == 100000);
+    const auto mapped = seq::mapped_binary<int>(path);
+    REQUIRE(std::vector<int>(mapped) == std::vector<int>(seq::iota(0, 100000)));
+
+    REQUIRE((values | seq::write_binary(path)) == 3);
+    REQUIRE(std::vector<std::int32_t>(seq::read_binary<std::int32_t>(path)) == std::vector<std::int32_t>{ 5, 6, 7 });
+    std::remove(path.c_str());
+
+    REQUIRE_THROWS_AS(seq::read_binary<int>("/nonexistent/millrind"), std::system_error);
+}
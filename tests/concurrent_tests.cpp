@@ -0,0 +1,663 @@
+#include <catch.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <millrind/async_buffer.hpp>
+#include <millrind/async_print.hpp>
+#include <millrind/channel.hpp>
+#include <millrind/concurrent_queue.hpp>
+#include <millrind/par_map.hpp>
+#include <millrind/seq.hpp>
+#include <millrind/thread_pool.hpp>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace millrind;
+
+SCENARIO("mpmc_queue", "[concurrent]")
+{
+    mpmc_queue<std::string> queue{ 3 };
+    REQUIRE(queue.capacity() == 4);
+    REQUIRE(queue.try_push(std::string{ "a" }));
+    REQUIRE(queue.try_push(std::string{ "b" }));
+    REQUIRE(queue.try_push(std::string{ "c" }));
+    REQUIRE(queue.try_push(std::string{ "d" }));
+    REQUIRE(queue.full());
+    REQUIRE(!queue.try_push(std::string{ "e" }));
+    REQUIRE(queue.try_pop() == std::optional<std::string>{ "a" });
+    REQUIRE(!queue.full());
+
+    std::string value;
+    REQUIRE(queue.try_pop(value));
+    REQUIRE(value == "b");
+}
+
+SCENARIO("mpmc_queue with concurrent producers and consumers", "[concurrent]")
+{
+    constexpr int producers = 4;
+    constexpr int per_producer = 10000;
+
+    mpmc_queue<int> queue{ 64 };
+    std::atomic<long long> sum{ 0 };
+    std::atomic<int> consumed{ 0 };
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&, p] {
+            for (int i = 1; i <= per_producer; ++i)
+            {
+                while (!queue.try_push(p * per_producer + i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&] {
+            while (consumed.load() < producers * per_producer)
+            {
+                if (const auto value = queue.try_pop())
+                {
+                    sum += *value;
+                    ++consumed;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    const long long n = producers * per_producer;
+    REQUIRE(sum.load() == n * (n + 1) / 2);
+}
+
+SCENARIO("async_printer writes whole lines from many threads", "[concurrent]")
+{
+    std::FILE* file = std::tmpfile();
+    constexpr int thread_count = 4;
+    constexpr int lines_per_thread = 2000;
+    {
+        async_printer printer{ ::fileno(file), 64 };
+        std::vector<std::thread> threads;
+        for (int t = 0; t < thread_count; ++t)
+        {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < lines_per_thread; ++i)
+                {
+                    printer.println("thread ", t, " line ", i, " payload ", std::string(t * 10 + 1, 'x'));
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        printer.flush();
+    }
+
+    std::rewind(file);
+    std::string content;
+    char buffer[4096];
+    while (const auto n = std::fread(buffer, 1, sizeof(buffer), file))
+    {
+        content.append(buffer, n);
+    }
+    std::fclose(file);
+
+    std::vector<int> counts(thread_count);
+    for (const auto line : content | seq::lines())
+    {
+        const auto t = line[7] - '0';
+        REQUIRE(line.substr(0, 7) == "thread ");
+        REQUIRE(line.size() > 10);
+        REQUIRE(line.substr(line.size() - (t * 10 + 1)) == std::string(t * 10 + 1, 'x'));
+        ++counts.at(t);
+    }
+    REQUIRE(counts == std::vector<int>(thread_count, lines_per_thread));
+}
+
+SCENARIO("async_printer survives write errors", "[concurrent]")
+{
+    async_printer printer{ -1, 8 };
+    for (int i = 0; i < 100; ++i)
+    {
+        printer.println("lost line ", i);
+    }
+    printer.flush();
+    REQUIRE(printer.error() == std::errc::bad_file_descriptor);
+}
+
+SCENARIO("spsc_queue", "[concurrent]")
+{
+    spsc_queue<std::string> queue{ 3 };
+    REQUIRE(queue.capacity() == 4);
+    REQUIRE(queue.empty());
+    REQUIRE(queue.try_push(std::string{ "a" }));
+    REQUIRE(queue.try_push(std::string{ "b" }));
+    REQUIRE(queue.try_push(std::string{ "c" }));
+    REQUIRE(queue.try_push(std::string{ "d" }));
+    REQUIRE(!queue.try_push(std::string{ "e" }));
+    REQUIRE(queue.try_pop() == std::optional<std::string>{ "a" });
+    REQUIRE(queue.try_push(std::string{ "e" }));
+
+    std::string value;
+    REQUIRE(queue.try_pop(value));
+    REQUIRE(value == "b");
+    REQUIRE(queue.try_pop() == std::optional<std::string>{ "c" });
+    REQUIRE(queue.try_pop() == std::optional<std::string>{ "d" });
+    REQUIRE(queue.try_pop() == std::optional<std::string>{ "e" });
+    REQUIRE(!queue.try_pop());
+}
+
+SCENARIO("spsc_queue transfers items between two threads in order", "[concurrent]")
+{
+    spsc_queue<int> queue{ 16 };
+    constexpr int count = 10000;
+
+    std::thread producer{ [&]
+                          {
+                              for (int i = 0; i < count; ++i)
+                              {
+                                  while (!queue.try_push(i))
+                                  {
+                                      std::this_thread::yield();
+                                  }
+                              }
+                          } };
+
+    std::vector<int> result;
+    while (result.size() < count)
+    {
+        if (auto item = queue.try_pop())
+            result.push_back(*item);
+        else
+            std::this_thread::yield();
+    }
+    producer.join();
+
+    std::vector<int> expected(count);
+    std::iota(expected.begin(), expected.end(), 0);
+    REQUIRE(result == expected);
+}
+
+SCENARIO("async_buffer runs upstream stages on a producer thread", "[concurrent]")
+{
+    const auto consumer_id = std::this_thread::get_id();
+    std::atomic<int> on_consumer{ 0 };
+
+    std::vector<int> result;
+    seq::iota(0, 1000)
+        | seq::map(
+            [&](int x)
+            {
+                if (std::this_thread::get_id() == consumer_id)
+                    ++on_consumer;
+                return x * 2;
+            })
+        | seq::async_buffer(16)
+        | seq::copy(std::back_inserter(result));
+
+    REQUIRE(result.size() == 1000);
+    REQUIRE(result[0] == 0);
+    REQUIRE(result[999] == 1998);
+    REQUIRE(std::is_sorted(result.begin(), result.end()));
+    REQUIRE(on_consumer == 0);
+}
+
+SCENARIO("async_buffer propagates producer exceptions to the consumer", "[concurrent]")
+{
+    auto range = seq::iota(0, 100)
+        | seq::map(
+            [](int x)
+            {
+                if (x == 50)
+                    throw std::runtime_error{ "boom" };
+                return x;
+            })
+        | seq::async_buffer(8);
+
+    std::vector<int> result;
+    REQUIRE_THROWS_AS(range | seq::copy(std::back_inserter(result)), std::runtime_error);
+    REQUIRE(result.size() == 50);
+    REQUIRE(result.back() == 49);
+}
+
+SCENARIO("async_buffer is a single-pass range that works with take", "[concurrent]")
+{
+    using iterator = iterator_t<decltype(seq::iota(0, 1) | seq::async_buffer(1))>;
+    static_assert(std::is_same_v<iter_category_t<iterator>, std::input_iterator_tag>);
+
+    const std::vector<std::string> words{ "alpha", "beta", "gamma", "delta" };
+    std::vector<std::string> result;
+    words | seq::async_buffer(2) | seq::take(3) | seq::copy(std::back_inserter(result));
+
+    REQUIRE(result == std::vector<std::string>{ "alpha", "beta", "gamma" });
+}
+
+SCENARIO("async_buffer can be collected through another adaptor", "[concurrent]")
+{
+    const std::vector<int> source{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    const auto range = source | seq::async_buffer(4) | seq::map([](int x) { return x; });
+    static_assert(std::is_same_v<iter_category_t<iterator_t<decltype(range)>>, std::input_iterator_tag>);
+
+    const std::vector<int> result = range;
+    REQUIRE(result == source);
+}
+
+SCENARIO("async_buffer cancels the producer when the range is dropped", "[concurrent]")
+{
+    std::atomic<int> produced{ 0 };
+    {
+        auto range = seq::iota(0, 1000000000)
+            | seq::map(
+                [&](int x)
+                {
+                    ++produced;
+                    return x;
+                })
+            | seq::async_buffer(8);
+        auto it = std::begin(range);
+        REQUIRE(*it == 0);
+        ++it;
+        REQUIRE(*it == 1);
+    }
+    REQUIRE(produced < 1000);
+}
+
+SCENARIO("thread_pool runs submitted tasks", "[concurrent]")
+{
+    thread_pool pool{ 3 };
+    REQUIRE(pool.size() == 3);
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 20; ++i)
+    {
+        futures.push_back(pool.submit([i] { return i * i; }));
+    }
+    for (int i = 0; i < 20; ++i)
+    {
+        REQUIRE(futures[i].get() == i * i);
+    }
+}
+
+SCENARIO("par_map preserves input order", "[concurrent]")
+{
+    std::atomic<int> in_flight{ 0 };
+    std::atomic<int> max_in_flight{ 0 };
+
+    std::vector<int> result;
+    seq::iota(0, 500)
+        | seq::par_map(
+            [&](int x)
+            {
+                const auto current = ++in_flight;
+                int expected = max_in_flight.load();
+                while (current > expected && !max_in_flight.compare_exchange_weak(expected, current))
+                {
+                }
+                std::this_thread::yield();
+                --in_flight;
+                return x * 3;
+            },
+            4,
+            8)
+        | seq::copy(std::back_inserter(result));
+
+    std::vector<int> expected(500);
+    std::iota(expected.begin(), expected.end(), 0);
+    std::transform(expected.begin(), expected.end(), expected.begin(), [](int x) { return x * 3; });
+    REQUIRE(result == expected);
+    REQUIRE(max_in_flight <= 4);
+}
+
+SCENARIO("par_map reads ahead at most a window of elements", "[concurrent]")
+{
+    std::atomic<int> started{ 0 };
+    auto range = seq::iota(0, 1000)
+        | seq::map(
+            [&](int x)
+            {
+                ++started;
+                return x;
+            })
+        | seq::par_map([](int x) { return x + 1; }, 2, 16);
+
+    auto it = std::begin(range);
+    REQUIRE(*it == 1);
+    REQUIRE(started <= 17);
+}
+
+SCENARIO("par_map is a single-pass range that works with take", "[concurrent]")
+{
+    const std::vector<std::string> words{ "alpha", "beta", "gamma", "delta", "epsilon" };
+    auto range = words | seq::par_map([](const std::string& word) { return word + "!"; }, 2, 4);
+    static_assert(std::is_same_v<iter_category_t<iterator_t<decltype(range)>>, std::input_iterator_tag>);
+
+    std::vector<std::string> result;
+    range | seq::take(3) | seq::copy(std::back_inserter(result));
+
+    REQUIRE(result == std::vector<std::string>{ "alpha!", "beta!", "gamma!" });
+}
+
+SCENARIO("par_map_unordered yields every result", "[concurrent]")
+{
+    std::vector<int> result;
+    seq::iota(0, 500) | seq::par_map_unordered([](int x) { return x * 3; }, 4, 16) | seq::copy(std::back_inserter(result));
+
+    std::sort(result.begin(), result.end());
+    REQUIRE(result.size() == 500);
+    REQUIRE(result.front() == 0);
+    REQUIRE(result.back() == 1497);
+    REQUIRE(std::adjacent_find(result.begin(), result.end()) == result.end());
+}
+
+SCENARIO("par_map propagates exceptions in input order", "[concurrent]")
+{
+    auto range = seq::iota(0, 100)
+        | seq::par_map(
+            [](int x)
+            {
+                if (x == 40)
+                    throw std::runtime_error{ "boom" };
+                return x;
+            },
+            4,
+            8);
+
+    std::vector<int> result;
+    REQUIRE_THROWS_AS(range | seq::copy(std::back_inserter(result)), std::runtime_error);
+    REQUIRE(result.size() == 40);
+    REQUIRE(result.back() == 39);
+}
+
+SCENARIO("par_map rethrows failures from upstream stages", "[concurrent]")
+{
+    const auto fail_at_five = [](int x)
+    {
+        if (x == 5)
+            throw std::runtime_error{ "boom" };
+        return x;
+    };
+
+    std::vector<int> result;
+    REQUIRE_THROWS_AS(
+        seq::iota(0, 100) | seq::map(fail_at_five) | seq::par_map([](int x) { return x * 2; }, 2, 4)
+            | seq::copy(std::back_inserter(result)),
+        std::runtime_error);
+    REQUIRE(result.size() <= 5);
+}
+
+SCENARIO("par_map results can be collected through another adaptor", "[concurrent]")
+{
+    const std::vector<int> result
+        = seq::iota(0, 10) | seq::par_map([](int x) { return x * x; }, 2, 4) | seq::map([](int x) { return x + 1; });
+    REQUIRE(result == std::vector<int>{ 1, 2, 5, 10, 17, 26, 37, 50, 65, 82 });
+}
+
+SCENARIO("channel send and receive", "[concurrent]")
+{
+    channel<int> ch{ 2 };
+    REQUIRE(ch.capacity() == 2);
+    REQUIRE(ch.try_send(1));
+    REQUIRE(ch.try_send(2));
+    REQUIRE(!ch.try_send(3));
+    REQUIRE(ch.try_receive() == std::optional<int>{ 1 });
+
+    ch.close();
+    REQUIRE(ch.closed());
+    REQUIRE(!ch.send(4));
+    REQUIRE(ch.receive() == std::optional<int>{ 2 });
+    REQUIRE(!ch.receive());
+}
+
+SCENARIO("channel feeds a pipeline from several producers", "[concurrent]")
+{
+    for (const auto wait : { channel_wait::block, channel_wait::spin })
+    {
+        channel<int> ch{ 16, wait };
+        constexpr int producer_count = 3;
+        constexpr int items_per_producer = 2000;
+
+        std::vector<std::thread> producers;
+        for (int p = 0; p < producer_count; ++p)
+        {
+            producers.emplace_back(
+                [&ch, p]
+                {
+                    for (int i = 0; i < items_per_producer; ++i)
+                    {
+                        ch.send(p * items_per_producer + i);
+                    }
+                });
+        }
+        std::thread closer{ [&]
+                            {
+                                for (auto& producer : producers)
+                                {
+                                    producer.join();
+                                }
+                                ch.close();
+                            } };
+
+        std::vector<int> result;
+        ch
+            | seq::filter([](int x) { return x % 2 == 0; })
+            | seq::map([](int x) { return x / 2; })
+            | seq::copy(std::back_inserter(result));
+        closer.join();
+
+        std::sort(result.begin(), result.end());
+        std::vector<int> expected(producer_count * items_per_producer / 2);
+        std::iota(expected.begin(), expected.end(), 0);
+        REQUIRE(result == expected);
+    }
+}
+
+SCENARIO("channel is a single-pass range that works with take", "[concurrent]")
+{
+    channel<std::string> ch{ 8 };
+    static_assert(std::is_same_v<iter_category_t<iterator_t<channel<std::string>&>>, std::input_iterator_tag>);
+
+    for (const auto& word : { "alpha", "beta", "gamma", "delta" })
+    {
+        ch.send(std::string{ word });
+    }
+    ch.close();
+
+    std::vector<std::string> result;
+    ch | seq::take(2) | seq::copy(std::back_inserter(result));
+    REQUIRE(result == std::vector<std::string>{ "alpha", "beta" });
+}
+
+SCENARIO("channel adaptors stay single-pass when collected", "[concurrent]")
+{
+    const auto fill = [](channel<int>& ch)
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            ch.send(i);
+        }
+        ch.close();
+    };
+
+    channel<int> mapped{ 16 };
+    fill(mapped);
+    const auto doubled = mapped | seq::map([](int x) { return x * 2; });
+    static_assert(std::is_same_v<iter_category_t<iterator_t<decltype(doubled)>>, std::input_iterator_tag>);
+    REQUIRE(std::vector<int>(doubled) == std::vector<int>{ 0, 2, 4, 6, 8, 10, 12, 14, 16, 18 });
+
+    channel<int> filtered{ 16 };
+    fill(filtered);
+    const std::vector<int> odd = filtered | seq::filter([](int x) { return x % 2 == 1; });
+    REQUIRE(odd == std::vector<int>{ 1, 3, 5, 7, 9 });
+}
+
+SCENARIO("channel wakes blocked senders when space frees up", "[concurrent]")
+{
+    channel<int> ch{ 1 };
+    constexpr int count = 2000;
+
+    std::thread producer{ [&]
+                          {
+                              for (int i = 0; i < count; ++i)
+                              {
+                                  ch.send(i);
+                              }
+                              ch.close();
+                          } };
+
+    int expected = 0;
+    for (const auto item : ch)
+    {
+        REQUIRE(item == expected++);
+    }
+    producer.join();
+    REQUIRE(expected == count);
+}
+
+SCENARIO("channel wakes blocked receivers on close", "[concurrent]")
+{
+    channel<std::string> ch{ 4 };
+    std::thread closer{ [&]
+                        {
+                            ch.send(std::string{ "last" });
+                            ch.close();
+                        } };
+
+    std::vector<std::string> result;
+    for (const auto& item : ch)
+    {
+        result.push_back(item);
+    }
+    closer.join();
+
+    REQUIRE(result == std::vector<std::string>{ "last" });
+}
+
+namespace
+{
+auto triples_with_hypotenuse(int z)
+{
+    std::vector<std::tuple<int, int, int>> result;
+    for (int x = 1; x <= z; ++x)
+    {
+        for (int y = x; y <= z; ++y)
+        {
+            if (x * x + y * y == z * z)
+                result.emplace_back(x, y, z);
+        }
+    }
+    return result;
+}
+
+}  // namespace
+
+SCENARIO("work_stealing_pool runs tasks posted from workers", "[concurrent]")
+{
+    work_stealing_pool pool{ 3 };
+    REQUIRE(pool.size() == 3);
+
+    std::atomic<int> count{ 0 };
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 10; ++i)
+    {
+        futures.push_back(pool.submit(
+            [&]
+            {
+                for (int j = 0; j < 10; ++j)
+                {
+                    pool.post([&] { ++count; });
+                }
+            }));
+    }
+    for (auto& future : futures)
+    {
+        future.get();
+    }
+    while (count < 100)
+    {
+        std::this_thread::yield();
+    }
+    REQUIRE(count == 100);
+}
+
+SCENARIO("par_flat_map flattens inner ranges in input order", "[concurrent]")
+{
+    work_stealing_pool pool{ 3 };
+
+    std::vector<std::tuple<int, int, int>> result;
+    seq::iota(1, 60) | seq::par_flat_map(triples_with_hypotenuse, pool) | seq::copy(std::back_inserter(result));
+
+    std::vector<std::tuple<int, int, int>> expected;
+    for (int z = 1; z < 60; ++z)
+    {
+        for (const auto& triple : triples_with_hypotenuse(z))
+        {
+            expected.push_back(triple);
+        }
+    }
+    REQUIRE(result == expected);
+    REQUIRE((seq::iota(1, 60) | seq::par_collect(triples_with_hypotenuse, pool)) == expected);
+
+    std::vector<std::tuple<int, int, int>> unordered;
+    seq::iota(1, 60) | seq::par_flat_map_unordered(triples_with_hypotenuse, pool) | seq::copy(std::back_inserter(unordered));
+    std::sort(unordered.begin(), unordered.end());
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(unordered == expected);
+}
+
+SCENARIO("par_flat_map stops an unbounded search after take", "[concurrent]")
+{
+    work_stealing_pool pool{ 2 };
+
+    std::vector<std::tuple<int, int, int>> result;
+    seq::iota(1, std::numeric_limits<int>::max())
+        | seq::par_flat_map(triples_with_hypotenuse, pool, 8)
+        | seq::take(5)
+        | seq::copy(std::back_inserter(result));
+
+    REQUIRE(result.size() == 5);
+    REQUIRE(result.front() == std::tuple{ 3, 4, 5 });
+    REQUIRE(result.back() == std::tuple{ 8, 15, 17 });
+}
+
+SCENARIO("par_for_each visits every element and rethrows failures", "[concurrent]")
+{
+    work_stealing_pool pool{ 3 };
+
+    std::atomic<int> sum{ 0 };
+    seq::iota(0, 1000) | seq::par_for_each([&](int x) { sum += x; }, pool);
+    REQUIRE(sum == 499500);
+
+    REQUIRE_THROWS_AS(
+        seq::iota(0, 1000)
+            | seq::par_for_each(
+                [](int x)
+                {
+                    if (x == 500)
+                        throw std::runtime_error{ "boom" };
+                },
+                pool),
+        std::runtime_error);
+}
+
+SCENARIO("parallel terminals rethrow failures from upstream stages", "[concurrent]")
+{
+    work_stealing_pool pool{ 2 };
+    const auto fail_at_five = [](int x)
+    {
+        if (x == 5)
+            throw std::runtime_error{ "boom" };
+        return x;
+    };
+
+    REQUIRE_THROWS_AS(seq::iota(0, 100) | seq::map(fail_at_five) | seq::par_collect(triples_with_hypotenuse, pool, 4), std::runtime_error);
+    REQUIRE_THROWS_AS(seq::iota(0, 100) | seq::map(fail_at_five) | seq::par_for_each([](int) {}, pool, 4), std::runtime_error);
+}
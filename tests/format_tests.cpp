@@ -0,0 +1,126 @@
+#include <catch.hpp>
+#include <iomanip>
+#include <millrind/format.hpp>
+#include <millrind/output.hpp>
+
+using namespace millrind;
+
+namespace
+{
+struct point
+{
+    int x;
+    int y;
+
+    friend std::ostream& operator<<(std::ostream& os, const point& item)
+    {
+        return os << "(" << item.x << ", " << item.y << ")";
+    }
+};
+
+}  // namespace
+
+SCENARIO("runtime format", "[format]")
+{
+    REQUIRE(format("{} + {} = {}", 1, 2, 3) == "1 + 2 = 3");
+    REQUIRE(format("{1}{0}{{}}", 'a', "b") == "ba{}");
+    REQUIRE_THROWS_AS(format("{", 1), detail::format_error);
+}
+
+SCENARIO("compile-time format", "[format]")
+{
+    static constexpr auto fmt = MILLRIND_FMT("{}: {} items, {{{}}} ratio={}");
+    static_assert(fmt.segments.size() == 8);
+    static_assert(fmt.arg_count() == 4);
+
+    REQUIRE(fmt("queue", 42, std::string{ "x" }, 0.5) == "queue: 42 items, {x} ratio=0.5");
+    REQUIRE(MILLRIND_FMT("{1}-{0}-{1}")(-7, 'z') == "z--7-z");
+    REQUIRE(MILLRIND_FMT("no arguments")() == "no arguments");
+    REQUIRE(MILLRIND_FMT("at {}")(point{ 1, 2 }) == "at (1, 2)");
+}
+
+SCENARIO("compiled format", "[format]")
+{
+    std::string config = "[{1}] {0:>8} took {2:.3f}ms";
+    const compiled_format fmt{ config };
+    config.clear();
+
+    REQUIRE(fmt.arg_count() == 3);
+    REQUIRE(fmt("parse", "info", 2) == "[info]    parse took 2.000ms");
+    REQUIRE(fmt("x", 'y', 0.25) == "[y]        x took 0.250ms");
+    REQUIRE_THROWS_AS(fmt("too few"), detail::format_error);
+    REQUIRE_THROWS_AS(compiled_format{ "{:?}" }, detail::format_error);
+    REQUIRE(compiled_format{ "{{}} {}" }(7) == "{} 7");
+}
+
+SCENARIO("format specs", "[format]")
+{
+    REQUIRE(format("{:x}|{:X}|{:o}|{:b}", 255, 255, 8, 5) == "ff|FF|10|101");
+    REQUIRE(format("{:>6}|{:<6}|{:^6}|{:*^7}", 42, 42, "ab", 'c') == "    42|42    |  ab  |***c***");
+    REQUIRE(format("{:08.3f}|{:06x}|{:05}", -3.14159, 48879, -42) == "-003.142|00beef|-0042");
+    REQUIRE(format("{:.2e}|{:.3}|{}", 12345.678, 2.0 / 3.0, 0.1) == "1.23e+04|0.667|0.1");
+    REQUIRE(format("{:.3}|{:6}|{:>8}", "abcdef", "ab", point{ 1, 2 }) == "abc|ab    |  (1, 2)");
+    REQUIRE(MILLRIND_FMT("{:>5x}")(255) == "   ff");
+}
+
+SCENARIO("floating point defaults match ostream output", "[format]")
+{
+    REQUIRE(format("{}|{}|{}", 1.0 / 3.0, 1e20, 123456789.0) == "0.333333|1e+20|1.23457e+08");
+    REQUIRE(format("{:f}|{:e}|{:g}", 1.5, 1.5, 1.5) == "1.500000|1.500000e+00|1.5");
+    REQUIRE(str_cat(2.0 / 3.0) == "0.666667");
+}
+
+SCENARIO("character-sized integers format as characters", "[format]")
+{
+    REQUIRE(format("{}|{}|{}", std::uint8_t{ 65 }, static_cast<signed char>('B'), 'C') == "A|B|C");
+    REQUIRE(format("{:d}|{:x}", std::uint8_t{ 65 }, static_cast<signed char>(15)) == "65|f");
+    REQUIRE(str_cat(std::uint8_t{ 'x' }, static_cast<signed char>('y')) == "xy");
+}
+
+SCENARIO("format_to writes into caller buffers", "[format]")
+{
+    static constexpr auto fmt = MILLRIND_FMT("{}={:.1f}");
+    const compiled_format compiled{ "{}={:.1f}" };
+    char buffer[32];
+
+    const auto end = format_to(buffer, "{}-{}", "id", 17);
+    REQUIRE(std::string_view(buffer, end - buffer) == "id-17");
+
+    REQUIRE(std::string_view(buffer, format_to(buffer, fmt, "x", 1.25) - buffer) == "x=1.2");
+    REQUIRE(std::string_view(buffer, format_to(buffer, compiled, "y", 2.75) - buffer) == "y=2.8");
+
+    const auto result = format_to_n(buffer, 4, "{}:{}", "truncated", 12345);
+    REQUIRE(result.size == 15);
+    REQUIRE(result.out == buffer + 4);
+    REQUIRE(std::string_view(buffer, 4) == "trun");
+
+    REQUIRE(formatted_size("{:>10}", 1) == 10);
+    REQUIRE(formatted_size(fmt, "abc", 0.0) == 7);
+    REQUIRE(formatted_size(compiled, "abc", 10.0) == 8);
+
+    std::string out = "> ";
+    format_to(std::back_inserter(out), "{}{}", 1, '!');
+    REQUIRE(out == "> 1!");
+}
+
+SCENARIO("str_cat and str_append", "[format]")
+{
+    REQUIRE(str_cat("cache:", 42, ':', std::string_view{ "user" }, '/', -7, "/", 2.5) == "cache:42:user/-7/2.5");
+    REQUIRE(str_cat() == "");
+    REQUIRE(str_cat(point{ 3, 4 }, std::string{ "!" }) == "(3, 4)!");
+
+    std::string key = "metric.";
+    REQUIRE(&str_append(key, "latency.", 99u) == &key);
+    REQUIRE(key == "metric.latency.99");
+
+    const auto reused = str_cat(std::numeric_limits<long long>::min(), -1.0 / 3.0);
+    REQUIRE(reused.capacity() - reused.size() < 64);
+}
+
+SCENARIO("str matches stream output", "[format]")
+{
+    REQUIRE(str("id=", 42, ' ', 1.0 / 3.0, ' ', true, std::string{ "!" }) == "id=42 0.333333 1!");
+    REQUIRE(str(std::uint8_t{ 65 }, -7L, 1e20) == "A-71e+20");
+    REQUIRE(str(point{ 1, 2 }, ':', 3) == "(1, 2):3");
+    REQUIRE(str(std::hex, 255, std::setw(4), 1) == "ff   1");
+}
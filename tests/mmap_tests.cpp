@@ -0,0 +1,62 @@
+#include <catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <millrind/mmap.hpp>
+#include <millrind/seq.hpp>
+
+using namespace millrind;
+
+namespace
+{
+struct temp_file
+{
+    std::string path;
+
+    explicit temp_file(std::string_view content)
+        : path{ "/tmp/millrind_mmap_XXXXXX" }
+    {
+        const int fd = ::mkstemp(path.data());
+        REQUIRE(fd >= 0);
+        ::close(fd);
+        std::ofstream{ path, std::ios::binary } << content;
+    }
+
+    ~temp_file()
+    {
+        std::remove(path.c_str());
+    }
+};
+
+}  // namespace
+
+SCENARIO("mapped_file", "[mmap]")
+{
+    const temp_file file{ "hello\nmapped\r\nworld" };
+    const mapped_file mapped{ file.path, mmap_options{ true, true } };
+    REQUIRE(mapped.size() == 19);
+    REQUIRE(mapped.view() == "hello\nmapped\r\nworld");
+
+    const temp_file empty{ "" };
+    REQUIRE(mapped_file{ empty.path }.empty());
+
+    REQUIRE_THROWS_AS(mapped_file{ "/nonexistent/millrind" }, std::system_error);
+}
+
+SCENARIO("mmap_range", "[mmap]")
+{
+    const temp_file file{ "4,8,15,16,23,42" };
+    const auto range = mmap_range(file.path);
+    REQUIRE(std::string(std::begin(range), std::end(range)) == "4,8,15,16,23,42");
+    REQUIRE(std::vector<int>(range | seq::split(',') | seq::filter_map(try_parse<int>)) == std::vector<int>{ 4, 8, 15, 16, 23, 42 });
+}
+
+SCENARIO("mapped_lines keep the mapping alive", "[mmap]")
+{
+    const temp_file file{ "first\nsecond\r\nthird\n" };
+    const auto range = seq::mapped_lines(file.path);
+    std::remove(file.path.c_str());
+
+    REQUIRE(std::vector<std::string_view>(range) == std::vector<std::string_view>{ "first", "second", "third" });
+    REQUIRE(std::vector<std::size_t>(range | seq::map([](std::string_view line) { return line.size(); }))
+            == std::vector<std::size_t>{ 5, 6, 5 });
+}
@@ -0,0 +1,99 @@
+#include <catch.hpp>
+#include <millrind/algorithm.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace millrind;
+
+namespace
+{
+struct record
+{
+    std::string name;
+    int key;
+};
+
+std::vector<record> make_records(int n)
+{
+    std::vector<record> result;
+    for (int i = 0; i < n; ++i)
+    {
+        result.push_back({ std::to_string(i), (i * 7919) % n });
+    }
+    return result;
+}
+
+}  // namespace
+
+SCENARIO("sort counts comparator and projection calls", "[operation_count]")
+{
+    operation_registry::instance().reset();
+
+    auto records = make_records(1000);
+    sort(records, [](int lhs, int rhs) { return lhs < rhs; }, [](const record& r) { return r.key; });
+
+    const auto counts = operation_registry::instance().counts("sort");
+    REQUIRE(std::is_sorted(records.begin(), records.end(), [](const record& lhs, const record& rhs) { return lhs.key < rhs.key; }));
+    REQUIRE(counts.comparisons > 1000);
+    REQUIRE(counts.projections == 2 * counts.comparisons);
+}
+
+SCENARIO("identity projections are not counted", "[operation_count]")
+{
+    operation_registry::instance().reset();
+
+    std::vector<int> values{ 5, 3, 1, 4, 2 };
+    stable_sort(values, [](int lhs, int rhs) { return lhs > rhs; });
+
+    const auto counts = operation_registry::instance().counts("stable_sort");
+    REQUIRE(counts.comparisons > 0);
+    REQUIRE(counts.projections == 0);
+}
+
+SCENARIO("operation_count_scope labels the call site", "[operation_count]")
+{
+    operation_registry::instance().reset();
+
+    std::vector<int> values(1024);
+    std::iota(values.begin(), values.end(), 0);
+    {
+        const operation_count_scope scope{ "lookup" };
+        lower_bound(values, 700, [](int lhs, int rhs) { return lhs < rhs; });
+    }
+
+    const auto counts = operation_registry::instance().counts("lookup:lower_bound");
+    REQUIRE(counts.comparisons > 0);
+    REQUIRE(counts.comparisons <= 11);
+    REQUIRE(operation_registry::instance().counts("lower_bound").comparisons == 0);
+}
+
+SCENARIO("unary algorithms count projection calls", "[operation_count]")
+{
+    operation_registry::instance().reset();
+
+    const auto records = make_records(100);
+    const auto result = all_of(records, [](int key) { return key >= 0; }, [](const record& r) { return r.key; });
+
+    REQUIRE(result);
+    REQUIRE(operation_registry::instance().counts("all_of").projections == 100);
+}
+
+SCENARIO("counted values report element moves", "[operation_count]")
+{
+    operation_registry::instance().reset();
+
+    std::vector<counted<int>> values;
+    for (int i = 0; i < 100; ++i)
+    {
+        values.push_back((i * 37) % 100);
+    }
+    sort(values, [](const counted<int>& lhs, const counted<int>& rhs) { return lhs < rhs; });
+
+    const auto counts = operation_registry::instance().counts("sort");
+    REQUIRE(std::is_sorted(values.begin(), values.end()));
+    REQUIRE(counts.moves > 0);
+    REQUIRE(counts.copies == 0);
+}
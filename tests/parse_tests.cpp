@@ -0,0 +1,87 @@
+#include <catch.hpp>
+#include <deque>
+#include <millrind/parse.hpp>
+#include <vector>
+
+using namespace millrind;
+
+SCENARIO("try_parse arithmetic values", "[parse]")
+{
+    REQUIRE(try_parse<int>("42") == std::optional{ 42 });
+    REQUIRE(try_parse<int>("+42") == std::optional{ 42 });
+    REQUIRE(try_parse<int>("-17") == std::optional{ -17 });
+    REQUIRE(try_parse<double>("2.5e3") == std::optional{ 2500.0 });
+    REQUIRE(try_parse<unsigned>("-1") == std::nullopt);
+    REQUIRE(try_parse<int>("12abc") == std::nullopt);
+    REQUIRE(try_parse<int>(" 12") == std::nullopt);
+    REQUIRE(try_parse<int>("") == std::nullopt);
+    REQUIRE(try_parse<int>("+-1") == std::nullopt);
+}
+
+SCENARIO("parse_errc reports why parsing failed", "[parse]")
+{
+    int value = 7;
+    REQUIRE(parse_errc<int>("123", ref{ value }) == std::errc{});
+    REQUIRE(value == 123);
+    REQUIRE(parse_errc<int>("99999999999", ref{ value }) == std::errc::result_out_of_range);
+    REQUIRE(parse_errc<int>("1.5", ref{ value }) == std::errc::invalid_argument);
+    REQUIRE(value == 123);
+}
+
+SCENARIO("parse falls back to streams for other types", "[parse]")
+{
+    REQUIRE(parse<std::string>("word") == "word");
+    REQUIRE(parse<char>("x") == 'x');
+    REQUIRE(parse<long long>("-9000000000") == -9000000000LL);
+    REQUIRE_THROWS_AS(parse<short>("70000"), std::runtime_error);
+}
+
+SCENARIO("parse_all agrees with try_parse", "[parse]")
+{
+    const std::vector<std::string> tokens{
+        "0",          "7",        "-7",          "+12",         "123456789",         "-2147483648", "2147483647",
+        "2147483648", "00000042", "12345678901", "1234567a",    "99999999999999999", "",            "-",
+        "1.5",        " 3",       "-0",          "+-3",         "87654321",          "-87654321",
+    };
+
+    for (const auto& token : tokens)
+    {
+        std::vector<int> values;
+        const auto result = parse_all<int>(token + ",5", ',', std::back_inserter(values));
+        if (const auto expected = try_parse<int>(token))
+        {
+            REQUIRE(result.error == std::nullopt);
+            REQUIRE(values == std::vector<int>{ *expected, 5 });
+        }
+        else
+        {
+            REQUIRE(result.error == std::optional<std::size_t>{ 0 });
+            REQUIRE(result.count == 0);
+        }
+    }
+}
+
+SCENARIO("parse_all reports the first malformed token", "[parse]")
+{
+    std::vector<long long> values;
+    const auto result = parse_all<long long>("10\n-9223372036854775808\n1234567890123\nx1\n5\n", '\n', std::back_inserter(values));
+    REQUIRE(result.count == 3);
+    REQUIRE(values == std::vector<long long>{ 10, std::numeric_limits<long long>::min(), 1234567890123LL });
+    REQUIRE(result.error == std::optional<std::size_t>{ 38 });
+
+    std::vector<double> doubles;
+    REQUIRE(parse_all<double>("1.5;-2e3;0.25;", ';', std::back_inserter(doubles)).error == std::nullopt);
+    REQUIRE(doubles == std::vector<double>{ 1.5, -2000.0, 0.25 });
+}
+
+SCENARIO("parse_all only accepts contiguous character ranges", "[parse]")
+{
+    static_assert(is_detected_v<detail::char_range, std::vector<char>&>);
+    static_assert(is_detected_v<detail::char_range, const char(&)[4]>);
+    static_assert(!is_detected_v<detail::char_range, std::deque<char>&>);
+
+    const std::vector<char> text{ '4', ',', '2' };
+    std::vector<int> values;
+    REQUIRE(parse_all<int>(text, ',', std::back_inserter(values)).error == std::nullopt);
+    REQUIRE(values == std::vector<int>{ 4, 2 });
+}
@@ -0,0 +1,99 @@
+#include <catch.hpp>
+#include <millrind/probe.hpp>
+#include <millrind/seq.hpp>
+
+using namespace millrind;
+
+SCENARIO("probe counts elements passing a stage", "[probe]")
+{
+    seq::reset_probes();
+
+    std::vector<int> result;
+    seq::iota(0, 100)
+        | seq::probe("source")
+        | seq::filter([](int x) { return x % 4 == 0; })
+        | seq::probe("filtered", "source")
+        | seq::map([](int x) { return x * x; })
+        | seq::copy(std::back_inserter(result));
+
+    REQUIRE(result.size() == 25);
+    REQUIRE(probe_registry::instance().get("source").elements == 100);
+    REQUIRE(probe_registry::instance().get("filtered").elements == 25);
+
+    const auto report = seq::probe_report();
+    REQUIRE(report.find("source") != std::string::npos);
+    REQUIRE(report.find("0.250") != std::string::npos);
+}
+
+SCENARIO("instrument wraps every stage of a pipeline", "[probe]")
+{
+    seq::reset_probes();
+
+    const auto pipeline = seq::instrument(
+        seq::filter([](int x) { return x % 2 == 0; }) | seq::map([](int x) { return x + 1; }) | seq::take_while([](int x) { return x < 50; }),
+        "p");
+
+    const std::vector<int> input(seq::iota(0, 1000));
+    std::vector<int> result;
+    input | pipeline | seq::copy(std::back_inserter(result));
+    REQUIRE(result == std::vector<int>(seq::iota(0, 25) | seq::map([](int x) { return 2 * x + 1; })));
+
+    auto& registry = probe_registry::instance();
+    REQUIRE(registry.get("p[0]").elements == 50);
+    REQUIRE(registry.get("p[1]").elements == 25);
+    REQUIRE(registry.get("p[2]").elements == 25);
+    REQUIRE(registry.get("p[3]").elements == 25);
+}
+
+SCENARIO("probe ratios are relative to the declared upstream probe", "[probe]")
+{
+    seq::reset_probes();
+
+    const std::vector<int> input(seq::iota(0, 100));
+    const std::vector<int> left
+        = input | seq::probe("left") | seq::filter([](int x) { return x % 2 == 0; }) | seq::probe("left half", "left");
+    const std::vector<int> right
+        = input | seq::probe("right") | seq::filter([](int x) { return x % 10 == 0; }) | seq::probe("right tenth", "right");
+    REQUIRE(left.size() == 50);
+    REQUIRE(right.size() == 10);
+
+    const auto pipeline = seq::instrument(seq::filter([](int x) { return x % 5 == 0; }), "reused");
+    REQUIRE(std::vector<int>(input | pipeline).size() == 20);
+    REQUIRE(std::vector<int>(input | seq::take(40) | pipeline).size() == 8);
+
+    const auto report = seq::probe_report();
+    const auto line_of = [&](std::string_view name)
+    {
+        const auto begin = report.find(name);
+        return report.substr(begin, report.find('\n', begin) - begin);
+    };
+    REQUIRE(line_of("left half").find("0.500") != std::string::npos);
+    REQUIRE(line_of("right tenth").find("0.100") != std::string::npos);
+    REQUIRE(line_of("reused[1]").find("0.200") != std::string::npos);
+    REQUIRE(line_of("left ").find(" - ") != std::string::npos);
+}
+
+SCENARIO("reset_probes keeps live probed ranges valid", "[probe]")
+{
+    auto range = seq::iota(0, 10) | seq::probe("reset");
+    seq::reset_probes();
+
+    std::vector<int> result;
+    range | seq::copy(std::back_inserter(result));
+
+    REQUIRE(result.size() == 10);
+    REQUIRE(probe_registry::instance().get("reset").elements == 10);
+}
+
+SCENARIO("probe keeps the category of the probed range", "[probe]")
+{
+    const std::vector<int> v{ 1, 2, 3, 4 };
+    const auto probed = v | seq::probe("random access");
+    static_assert(std::is_same_v<iter_category_t<iterator_t<decltype(probed)>>, std::random_access_iterator_tag>);
+
+    REQUIRE(std::vector<int>(v | seq::probe("reversed") | seq::reverse()) == std::vector<int>{ 4, 3, 2, 1 });
+    REQUIRE(probed.size() == 4);
+
+    const auto pipeline = seq::instrument(seq::map([](int x) { return x * 10; }) | seq::reverse(), "ra");
+    REQUIRE(std::vector<int>(v | pipeline) == std::vector<int>{ 40, 30, 20, 10 });
+}
@@ -0,0 +1,77 @@
+#include <catch.hpp>
+#include <deque>
+#include <millrind/algorithm.hpp>
+#include <millrind/searchers.hpp>
+#include <vector>
+
+using namespace millrind;
+
+SCENARIO("memmem_searcher", "[search]")
+{
+    const std::string text = "the quick brown fox jumps over the lazy dog, the quick brown cat";
+    REQUIRE(search<return_found>(text, memmem_searcher{ "brown cat" }) - text.begin() == 55);
+    REQUIRE(search<return_found>(text, memmem_searcher{ "fox" }) - text.begin() == 16);
+    REQUIRE(search<return_found>(text, memmem_searcher{ "t" }) - text.begin() == 0);
+    REQUIRE(search<return_found>(text, memmem_searcher{ "dogs" }) == text.end());
+    REQUIRE(search<return_found>(text, memmem_searcher{ "" }) == text.begin());
+}
+
+SCENARIO("memmem_searcher agrees with std::search", "[search]")
+{
+    std::string text;
+    for (int i = 0; i < 2000; ++i)
+        text.push_back("abc"[(i * i + i / 7) % 3]);
+
+    for (const std::string needle : { "a", "ab", "abc", "cba", "aaa", "bcab", "cccc", "abcabcab" })
+    {
+        REQUIRE(search<return_found>(text, memmem_searcher{ needle }) == std::search(text.begin(), text.end(), needle.begin(), needle.end()));
+    }
+}
+
+SCENARIO("aho_corasick_searcher", "[search]")
+{
+    const std::string_view text = "2024-01-01 WARN disk almost full; ERROR disk full";
+    const aho_corasick_searcher searcher{ "ERROR", "WARN", "FATAL" };
+
+    const auto m = searcher.find(text);
+    REQUIRE(m);
+    REQUIRE(m->pattern == 1);
+    REQUIRE(std::string_view(&*std::begin(m->range), m->range.size()) == "WARN");
+    REQUIRE(search<return_found>(text, searcher) - text.begin() == 11);
+    REQUIRE(!searcher.find(std::string_view{ "all good" }));
+}
+
+SCENARIO("aho_corasick_searcher reports the longest pattern ending first", "[search]")
+{
+    const aho_corasick_searcher searcher{ "he", "she", "his", "hers" };
+    const std::string_view text = "ushers";
+    const auto m = searcher.find(text);
+    REQUIRE(m);
+    REQUIRE(m->pattern == 1);
+    REQUIRE(std::begin(m->range) - text.begin() == 1);
+}
+
+SCENARIO("searchers are copyable and require contiguous bytes", "[search]")
+{
+    memmem_searcher memmem{ "fox" };
+    memmem_searcher memmem_copy{ memmem };
+    std::vector<memmem_searcher> memmem_searchers;
+    memmem_searchers.push_back(memmem);
+
+    aho_corasick_searcher aho_corasick{ "fox", "dog" };
+    aho_corasick_searcher aho_corasick_copy{ aho_corasick };
+    std::vector<aho_corasick_searcher> aho_corasick_searchers;
+    aho_corasick_searchers.push_back(aho_corasick);
+
+    const std::string text = "lazy dog, quick fox";
+    REQUIRE(search<return_found>(text, memmem_copy) - text.begin() == 16);
+    REQUIRE(search<return_found>(text, memmem_searchers.front()) - text.begin() == 16);
+    REQUIRE(search<return_found>(text, aho_corasick_copy) - text.begin() == 5);
+    REQUIRE(search<return_found>(text, aho_corasick_searchers.front()) - text.begin() == 5);
+
+    using deque_iterator = std::deque<char>::const_iterator;
+    static_assert(std::is_invocable_v<const memmem_searcher&, const char*, const char*>);
+    static_assert(std::is_invocable_v<const memmem_searcher&, std::vector<char>::iterator, std::vector<char>::iterator>);
+    static_assert(!std::is_invocable_v<const memmem_searcher&, deque_iterator, deque_iterator>);
+    static_assert(!std::is_invocable_v<const aho_corasick_searcher&, deque_iterator, deque_iterator>);
+}
@@ -0,0 +1,299 @@
+#include <catch.hpp>
+#include <deque>
+#include <millrind/seq.hpp>
+#include <millrind/std_ostream.hpp>
+
+using namespace millrind;
+
+SCENARIO("top_k", "[seq]")
+{
+    const std::vector<int> v{ 5, 3, 9, 1, 7, 2, 8 };
+    REQUIRE((v | seq::top_k(3)) == std::vector<int>{ 1, 2, 3 });
+    REQUIRE((v | seq::top_k(3, std::greater<>{})) == std::vector<int>{ 9, 8, 7 });
+    REQUIRE((v | seq::top_k(10)) == std::vector<int>{ 1, 2, 3, 5, 7, 8, 9 });
+    REQUIRE((v | seq::top_k(0)).empty());
+}
+
+SCENARIO("top_k over input range", "[seq]")
+{
+    const auto res = seq::iota(0, 1000) | seq::filter([](int x) { return x % 3 == 0; }) | seq::top_k(2, std::greater<>{});
+    REQUIRE(res == std::vector<int>{ 999, 996 });
+}
+
+SCENARIO("top_k with projection", "[seq]")
+{
+    const std::vector<std::pair<int, char>> v{ { 3, 'a' }, { 1, 'b' }, { 2, 'c' } };
+    REQUIRE((v | seq::top_k(2, std::less<>{}, &std::pair<int, char>::first)) == std::vector<std::pair<int, char>>{ { 1, 'b' }, { 2, 'c' } });
+}
+
+SCENARIO("par_top_k", "[seq]")
+{
+    const std::vector<std::vector<int>> partitions{ { 5, 3, 9 }, {}, { 1, 7 }, { 2, 8, 6 } };
+    REQUIRE((partitions | seq::par_top_k(4, std::greater<>{})) == std::vector<int>{ 9, 8, 7, 6 });
+}
+
+SCENARIO("distinct", "[seq]")
+{
+    const std::vector<int> v{ 3, 1, 3, 2, 1, 4, 3 };
+    REQUIRE(std::vector<int>(v | seq::distinct()) == std::vector<int>{ 3, 1, 2, 4 });
+    REQUIRE(std::vector<int>(v | seq::distinct([](int x) { return x % 2; })) == std::vector<int>{ 3, 2 });
+}
+
+SCENARIO("distinct over input range", "[seq]")
+{
+    const auto res = seq::iota(0, 100000) | seq::map([](int x) { return x % 1000; }) | seq::distinct();
+    REQUIRE(std::vector<int>(res) == std::vector<int>(seq::iota(0, 1000)));
+}
+
+SCENARIO("distinct with a stateful hasher", "[seq]")
+{
+    const std::size_t seed = 17;
+    const auto hash = [seed](int x) { return std::hash<int>{}(x) ^ seed; };
+    const std::vector<int> v{ 3, 1, 3, 2, 1, 4, 3 };
+
+    const auto res = v | seq::distinct(identity{}, hash);
+    static_assert(std::is_same_v<iter_category_t<iterator_t<decltype(res)>>, std::input_iterator_tag>);
+    REQUIRE(std::vector<int>(res) == std::vector<int>{ 3, 1, 2, 4 });
+}
+
+SCENARIO("distinct can be traversed more than once", "[seq]")
+{
+    const std::vector<int> v{ 3, 1, 3, 2, 1, 4 };
+    const auto res = v | seq::distinct();
+
+    const std::vector<int> first = res;
+    const std::vector<int> second = res;
+    REQUIRE(first == std::vector<int>{ 3, 1, 2, 4 });
+    REQUIRE(second == first);
+
+    const std::vector<int> mapped = v | seq::distinct() | seq::map([](int x) { return x * 10; });
+    REQUIRE(mapped == std::vector<int>{ 30, 10, 20, 40 });
+
+    const std::vector<int> w{ 1, 4 };
+    const auto except = v | seq::except(w);
+    REQUIRE(std::vector<int>(except) == std::vector<int>{ 3, 2 });
+    REQUIRE(std::vector<int>(except) == std::vector<int>{ 3, 2 });
+}
+
+SCENARIO("intersect_with", "[seq]")
+{
+    const std::vector<int> v{ 5, 1, 4, 1, 2, 5 };
+    const std::vector<int> w{ 2, 5, 7 };
+    REQUIRE(std::vector<int>(v | seq::intersect_with(w)) == std::vector<int>{ 5, 2 });
+}
+
+SCENARIO("except", "[seq]")
+{
+    const std::vector<std::string> v{ "a", "bb", "a", "ccc", "dd" };
+    const std::vector<std::string> w{ "bb" };
+    REQUIRE(std::vector<std::string>(v | seq::except(w)) == std::vector<std::string>{ "a", "ccc", "dd" });
+}
+
+SCENARIO("flat_hash_set", "[seq]")
+{
+    flat_hash_set<int> set;
+    for (int i = 0; i < 1000; ++i)
+        REQUIRE(set.insert(i));
+    REQUIRE(!set.insert(500));
+    for (int i = 0; i < 1000; i += 2)
+        REQUIRE(set.erase(i));
+    REQUIRE(set.size() == 500);
+    REQUIRE(!set.contains(10));
+    REQUIRE(set.contains(11));
+}
+
+SCENARIO("group_by", "[seq]")
+{
+    const std::vector<std::pair<std::string, int>> v{ { "a", 1 }, { "b", 5 }, { "a", 3 }, { "c", 2 }, { "b", 1 } };
+    auto res = std::vector<std::tuple<std::string, std::size_t, int, int, int, double>>(
+        v | seq::group_by(
+            element<0>,
+            agg::count(),
+            agg::sum(element<1>),
+            agg::min(element<1>),
+            agg::max(element<1>),
+            agg::avg(element<1>)));
+    std::sort(res.begin(), res.end());
+    REQUIRE(res.size() == 3);
+    REQUIRE(res[0] == std::tuple{ std::string{ "a" }, std::size_t{ 2 }, 4, 1, 3, 2.0 });
+    REQUIRE(res[1] == std::tuple{ std::string{ "b" }, std::size_t{ 2 }, 6, 1, 5, 3.0 });
+    REQUIRE(res[2] == std::tuple{ std::string{ "c" }, std::size_t{ 1 }, 2, 2, 2, 2.0 });
+}
+
+SCENARIO("group_by with custom aggregator", "[seq]")
+{
+    const auto concat = agg::make(std::string{}, [](std::string s, char c) { return s + c; }, std::plus<>{});
+    auto res = std::vector<std::tuple<bool, std::string>>(
+        std::string{ "abcdef" } | seq::group_by([](char c) { return c < 'd'; }, concat));
+    std::sort(res.begin(), res.end());
+    REQUIRE(res == std::vector<std::tuple<bool, std::string>>{ { false, "def" }, { true, "abc" } });
+}
+
+SCENARIO("par_group_by", "[seq]")
+{
+    const std::vector<int> v(seq::iota(0, 100000));
+    auto res = std::vector<std::tuple<int, std::size_t, long>>(
+        v | seq::par_group_by([](int x) { return x % 7; }, agg::count(), agg::sum([](int x) { return long{ x }; })));
+    std::sort(res.begin(), res.end());
+    REQUIRE(res.size() == 7);
+    REQUIRE(std::get<1>(res[0]) == 14286);
+    REQUIRE(accumulate(res, 0L, std::plus<>{}, element<2>) == 4999950000L);
+}
+
+SCENARIO("merge", "[seq]")
+{
+    const std::vector<int> a{ 1, 4, 7 };
+    const std::vector<int> b{ 2, 5, 8, 9 };
+    std::vector<int> c{ 0, 3, 6 };
+    REQUIRE(std::vector<int>(seq::merge(a, b, c)) == std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+    REQUIRE(std::vector<int>(seq::merge(a | seq::reverse(), b | seq::reverse(), std::greater<>{})) == std::vector<int>{ 9, 8, 7, 5, 4, 2, 1 });
+}
+
+SCENARIO("merge is stable", "[seq]")
+{
+    using item = std::pair<int, char>;
+    const std::vector<item> a{ { 1, 'a' }, { 2, 'a' } };
+    const std::vector<item> b{ { 1, 'b' }, { 2, 'b' } };
+    REQUIRE(std::vector<item>(seq::merge(a, b, std::less<>{}, &item::first)) == std::vector<item>{ { 1, 'a' }, { 1, 'b' }, { 2, 'a' }, { 2, 'b' } });
+}
+
+SCENARIO("merge_all", "[seq]")
+{
+    std::vector<std::vector<int>> shards(17);
+    for (int i = 0; i < 1000; ++i)
+        shards[(i * 7) % shards.size()].push_back(i);
+    shards.emplace_back();
+    REQUIRE(std::vector<int>(shards | seq::merge_all()) == std::vector<int>(seq::iota(0, 1000)));
+    REQUIRE((std::vector<std::vector<int>>{} | seq::merge_all()).empty());
+}
+
+SCENARIO("scan", "[seq]")
+{
+    const std::vector<int> v{ 1, 2, 3, 4 };
+    REQUIRE(std::vector<int>(v | seq::scan(0)) == std::vector<int>{ 1, 3, 6, 10 });
+    REQUIRE(std::vector<int>(v | seq::scan(1, std::multiplies<>{})) == std::vector<int>{ 1, 2, 6, 24 });
+    REQUIRE(std::vector<int>(v | seq::scan(0, std::plus<>{}, [](int x) { return x * x; })) == std::vector<int>{ 1, 5, 14, 30 });
+    REQUIRE((std::vector<int>{} | seq::scan(0)).empty());
+}
+
+SCENARIO("scan over input range", "[seq]")
+{
+    const auto res = seq::iota(1, 100) | seq::filter([](int x) { return x % 10 == 0; }) | seq::scan(0);
+    REQUIRE(std::vector<int>(res) == std::vector<int>{ 10, 30, 60, 100, 150, 210, 280, 360, 450 });
+}
+
+SCENARIO("par_inclusive_scan and par_exclusive_scan", "[seq]")
+{
+    const std::vector<long> v(seq::iota(0L, 200001L));
+    std::vector<long> expected(v.size());
+    std::vector<long> actual(v.size());
+
+    std::inclusive_scan(v.begin(), v.end(), expected.begin());
+    REQUIRE(par_inclusive_scan(v, actual.begin()) == actual.end());
+    REQUIRE(actual == expected);
+
+    std::exclusive_scan(v.begin(), v.end(), expected.begin(), 10L);
+    par_exclusive_scan(v, actual.begin(), 10L);
+    REQUIRE(actual == expected);
+}
+
+SCENARIO("lazy set operations", "[seq]")
+{
+    const std::vector<int> a{ 1, 2, 2, 4, 6, 8, 9 };
+    const std::vector<int> b{ 2, 3, 4, 4, 9, 10 };
+
+    const auto check = [&](auto lazy, auto eager) {
+        std::vector<int> expected;
+        eager(a, b, std::back_inserter(expected));
+        REQUIRE(std::vector<int>(a | lazy) == expected);
+    };
+
+    check(seq::set_union(b), [](auto&&... args) { return set_union(args...); });
+    check(seq::set_intersection(b), [](auto&&... args) { return set_intersection(args...); });
+    check(seq::set_difference(b), [](auto&&... args) { return set_difference(args...); });
+    check(seq::set_symmetric_difference(b), [](auto&&... args) { return set_symmetric_difference(args...); });
+}
+
+SCENARIO("lazy set operations gallop over skewed inputs", "[seq]")
+{
+    const std::vector<int> big(seq::iota(0, 100000) | seq::map([](int x) { return 3 * x; }));
+    const std::vector<int> small{ -1, 3, 4, 299997, 300000 };
+    int comparisons = 0;
+    const auto compare = [&](int l, int r) {
+        ++comparisons;
+        return l < r;
+    };
+
+    REQUIRE(std::vector<int>(small | seq::set_intersection(big, compare)) == std::vector<int>{ 3, 299997 });
+    REQUIRE(comparisons < 200);
+    REQUIRE(std::vector<int>(small | seq::set_difference(big)) == std::vector<int>{ -1, 4, 300000 });
+    REQUIRE(std::vector<int>(seq::iota(0, 10) | seq::set_intersection(seq::iota(5, 20))) == std::vector<int>{ 5, 6, 7, 8, 9 });
+}
+
+SCENARIO("parse_numbers", "[seq]")
+{
+    const std::string text = "3,14,15,92,65";
+    REQUIRE(std::vector<int>(text | seq::parse_numbers<int>()) == std::vector<int>{ 3, 14, 15, 92, 65 });
+    REQUIRE(std::vector<unsigned>(std::string_view{ "7 8 9 " } | seq::parse_numbers<unsigned>(' ')) == std::vector<unsigned>{ 7, 8, 9 });
+    REQUIRE(std::vector<double>(std::string{} | seq::parse_numbers<double>()).empty());
+
+    try
+    {
+        std::vector<int>(std::string_view{ "1,2,oops,4" } | seq::parse_numbers<int>());
+        FAIL();
+    }
+    catch (const parse_error& error)
+    {
+        REQUIRE(error.position == 4);
+    }
+}
+
+SCENARIO("split", "[seq]")
+{
+    using tokens = std::vector<std::string_view>;
+
+    const std::string text = "a,bc,,d,";
+    REQUIRE(tokens(text | seq::split(',')) == tokens{ "a", "bc", "", "d", "" });
+    REQUIRE(tokens(std::string_view{ "one::two::" } | seq::split("::")) == tokens{ "one", "two", "" });
+    REQUIRE(tokens(std::string_view{ "no delimiter" } | seq::split(',')) == tokens{ "no delimiter" });
+    REQUIRE(tokens(std::string{} | seq::split(',')).empty());
+
+    const auto first = *std::begin(text | seq::split(','));
+    REQUIRE(first.data() == text.data());
+
+    REQUIRE(std::vector<int>(std::string_view{ "1,x,22,,333" } | seq::split(',') | seq::filter_map(try_parse<int>))
+            == std::vector<int>{ 1, 22, 333 });
+}
+
+SCENARIO("split requires contiguous characters", "[seq]")
+{
+    using tokens = std::vector<std::string_view>;
+
+    const std::vector<char> chars{ 'a', ',', 'b' };
+    REQUIRE(tokens(chars | seq::split(',')) == tokens{ "a", "b" });
+
+    static_assert(std::is_invocable_v<const seq::detail::split_fn&, const std::vector<char>&, char>);
+    static_assert(!std::is_invocable_v<const seq::detail::split_fn&, const std::deque<char>&, char>);
+    static_assert(!std::is_invocable_v<const seq::detail::lines_fn&, const std::deque<char>&>);
+    static_assert(!std::is_invocable_v<const seq::detail::split_any_fn&, decltype(chars | seq::reverse()), std::string_view>);
+}
+
+SCENARIO("split_any", "[seq]")
+{
+    using tokens = std::vector<std::string_view>;
+
+    const std::string text = "alpha beta\tgamma;delta epsilon zeta;eta theta iota kappa";
+    REQUIRE(tokens(text | seq::split_any(" \t;"))
+            == tokens{ "alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta", "theta", "iota", "kappa" });
+    REQUIRE(tokens(std::string_view{ "a-b" } | seq::split_any("-")) == tokens{ "a", "b" });
+}
+
+SCENARIO("lines", "[seq]")
+{
+    using tokens = std::vector<std::string_view>;
+
+    REQUIRE(tokens(std::string_view{ "first\nsecond\r\n\nlast" } | seq::lines()) == tokens{ "first", "second", "", "last" });
+    REQUIRE(tokens(std::string_view{ "x\ny\n" } | seq::lines()) == tokens{ "x", "y" });
+    REQUIRE(tokens(std::string_view{ "abc\r\nlast\r" } | seq::lines()) == tokens{ "abc", "last" });
+    REQUIRE(tokens(std::string_view{ "" } | seq::lines()).empty());
+}
@@ -0,0 +1,73 @@
+#include <catch.hpp>
+#include <cstdio>
+#include <millrind/writer.hpp>
+#include <sstream>
+#include <vector>
+
+using namespace millrind;
+
+namespace
+{
+std::string read_all(std::FILE* file)
+{
+    std::fflush(file);
+    std::rewind(file);
+    std::string result;
+    char buffer[256];
+    while (const auto n = std::fread(buffer, 1, sizeof(buffer), file))
+    {
+        result.append(buffer, n);
+    }
+    return result;
+}
+
+}  // namespace
+
+SCENARIO("buffered_writer over a file descriptor", "[writer]")
+{
+    std::FILE* file = std::tmpfile();
+    {
+        buffered_writer writer{ ::fileno(file), 8 };
+        writer << "answer=" << 42 << ' ' << -1.5 << ' ' << std::string{ "long enough to bypass the buffer" };
+        writer.fill(3, '.');
+        REQUIRE(writer.size() <= writer.capacity());
+    }
+    REQUIRE(read_all(file) == "answer=42 -1.5 long enough to bypass the buffer...");
+    std::fclose(file);
+}
+
+SCENARIO("buffered_writer clamps a zero capacity", "[writer]")
+{
+    std::FILE* file = std::tmpfile();
+    {
+        buffered_writer writer{ ::fileno(file), 0 };
+        REQUIRE(writer.capacity() == 1);
+        writer.put('a');
+        writer.fill(3, '-');
+        writer << 7;
+    }
+    REQUIRE(read_all(file) == "a---7");
+    std::fclose(file);
+}
+
+SCENARIO("buffered_writer over a FILE and writer_iterator", "[writer]")
+{
+    std::FILE* file = std::tmpfile();
+    buffered_writer writer{ file };
+
+    const std::vector<int> values{ 1, 2, 3 };
+    std::copy(values.begin(), values.end(), writer_iterator{ writer, ";" });
+    writer << delimit(values, ", ", [](int x) { return x * 10; });
+    REQUIRE(read_all(file).empty());
+
+    writer.flush();
+    REQUIRE(read_all(file) == "1;2;3;10, 20, 30");
+    std::fclose(file);
+}
+
+SCENARIO("delimit streams to ostreams without type erasure", "[writer]")
+{
+    std::ostringstream os;
+    os << delimit(std::vector<std::string>{ "a", "b", "c" }, "-");
+    REQUIRE(os.str() == "a-b-c");
+}